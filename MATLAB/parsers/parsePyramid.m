@@ -0,0 +1,27 @@
+function [x, mn, mx] = parsePyramid(fname, maxPoints)
+
+    %% Read the finest level of a min/max pyramid with at most maxPoints bins
+    fid = fopen(fname, "r");
+
+    magic = fread(fid, 8, '*char')';
+    if ~strcmp(magic, 'DSPPYR01')
+        fclose(fid);
+        error('Not a pyramid file: %s', fname);
+    end
+    counts = fread(fid, 2, 'uint64');
+    header = reshape(fread(fid, 2 * counts(2), 'uint64'), 2, [])';
+
+    % Levels run from finest to coarsest, skip the ones with too many bins
+    level = find(header(:, 2) <= maxPoints, 1);
+    if isempty(level)
+        level = size(header, 1);
+    end
+    fseek(fid, 16 * sum(header(1:level-1, 2)), 'cof');
+    pairs = fread(fid, [2, header(level, 2)], 'double');
+
+    fclose(fid);
+
+    x = (0:header(level, 2)-1)' * header(level, 1) + 1;
+    mn = pairs(1, :)';
+    mx = pairs(2, :)';
+end
@@ -10,6 +10,14 @@ elseif type == 'f'
     figure();
     iq = parseDouble(filename);
     plot(1:length(iq), real(iq));
+% Plot a min/max pyramid as an envelope at screen resolution
+elseif type == 'p'
+    figure();
+    [x, mn, mx] = parsePyramid(filename, 2000);
+    stairs(x, mx);
+    hold on;
+    stairs(x, mn);
+    hold off;
 end
 
 
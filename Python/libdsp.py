@@ -0,0 +1,145 @@
+"""
+Python bindings for libdsp.
+
+Arrays are handed to the shared library through their buffer pointers, never as Python
+lists. Inputs that are already C-contiguous float64 (or complex128) pass straight
+through; anything else is converted once by NumPy. complex128 has the same (re, im)
+layout as complex_t. fft(inplace=True) transforms the caller's memory; every other
+function reads the input array in place and writes straight into the output array it
+returns, as described in capi.h.
+
+main writes raw .f64 and .c128 files next to its text output. parseFile.parseFileAsRaw
+(plotFile.py -t f64 or -t c128) loads those with np.fromfile, so the path from the C++
+tools to a plot never goes through text.
+
+ctypes releases the GIL for the duration of every call, so Python threads can run DSP
+work in parallel.
+
+The library is loaded from $LIBDSP_PATH, or ../cpp/build/libdsp.so next to this file.
+"""
+import ctypes
+import os
+import numpy as np
+
+_libPath = os.environ.get('LIBDSP_PATH',
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'cpp', 'build', 'libdsp.so'))
+_lib = ctypes.CDLL(_libPath)
+
+_size = ctypes.c_size_t
+_ptr = ctypes.c_void_p
+
+_lib.dsp_fft.argtypes = [_ptr, _size, ctypes.c_int]
+_lib.dsp_rfft.argtypes = [_ptr, _size, _ptr]
+_lib.dsp_convolve.argtypes = [_ptr, _size, _ptr, _size, _ptr]
+_lib.dsp_welch_psd.argtypes = [_ptr, _size, _size, _size, ctypes.c_int, ctypes.c_int,
+                               ctypes.c_double, _size, _ptr]
+_lib.dsp_welch_psd.restype = _size
+_lib.dsp_moving.argtypes = [_ptr, _size, _size, ctypes.c_int, _ptr]
+_lib.dsp_analytic.argtypes = [_ptr, _size, _ptr]
+_lib.dsp_analytic_features.argtypes = [_ptr, _size, ctypes.c_double, _ptr, _ptr, _ptr]
+_lib.dsp_find_peaks.argtypes = [_ptr, _size, ctypes.c_double, _size, _ptr, _ptr, _size]
+_lib.dsp_find_peaks.restype = _size
+
+# Match the WindowType and WelchAverage enums
+WINDOWS = {'rectangular': 0, 'hann': 1, 'hamming': 2, 'blackman': 3}
+AVERAGES = {'mean': 0, 'median': 1, 'exponential': 2}
+_MOVING = {'sum': 0, 'mean': 1, 'rms': 2, 'var': 3, 'max': 4, 'min': 5}
+
+
+def _real(x):
+    return np.ascontiguousarray(x, dtype=np.float64)
+
+
+def _complex(x):
+    return np.ascontiguousarray(x, dtype=np.complex128)
+
+
+def _addr(a):
+    return a.ctypes.data
+
+
+def fft(data, inverse=False, inplace=False):
+    """FFT of any length. With inplace, a complex128 C-contiguous array is transformed in its own memory."""
+    if inplace:
+        if not (isinstance(data, np.ndarray) and data.dtype == np.complex128
+                and data.flags['C_CONTIGUOUS'] and data.flags['WRITEABLE']):
+            raise ValueError('inplace needs a writeable C-contiguous complex128 array')
+        out = data
+    else:
+        out = np.array(data, dtype=np.complex128, order='C')
+    _lib.dsp_fft(_addr(out), out.size, 1 if inverse else 0)
+    return out
+
+
+def ifft(data, inplace=False):
+    """Inverse FFT, scaled by 1/N."""
+    return fft(data, inverse=True, inplace=inplace)
+
+
+def rfft(data):
+    """FFT of a real signal, all N bins."""
+    x = _real(data)
+    out = np.empty(x.size, dtype=np.complex128)
+    _lib.dsp_rfft(_addr(x), x.size, _addr(out))
+    return out
+
+
+def convolve(sig, kernel):
+    """Full convolution, len(sig) + len(kernel) - 1 samples."""
+    x = _real(sig)
+    h = _real(kernel)
+    if x.size == 0 or h.size == 0:
+        return np.empty(0)
+    out = np.empty(x.size + h.size - 1)
+    _lib.dsp_convolve(_addr(x), x.size, _addr(h), h.size, _addr(out))
+    return out
+
+
+def welchPSD(sig, segment, overlap=None, window='hann', average='mean', sampleRate=1.0, threads=0):
+    """Two-sided Welch PSD with segment bins. overlap defaults to half a segment."""
+    x = _real(sig)
+    if segment < 1 or segment > x.size:
+        raise ValueError('segment must be between 1 and the signal length')
+    if overlap is None:
+        overlap = segment // 2
+    out = np.zeros(segment)
+    _lib.dsp_welch_psd(_addr(x), x.size, segment, overlap, WINDOWS[window], AVERAGES[average],
+                       sampleRate, threads, _addr(out))
+    return out
+
+
+def moving(sig, window, stat='mean'):
+    """Sliding window sum, mean, rms, var, max or min."""
+    x = _real(sig)
+    out = np.empty(x.size)
+    _lib.dsp_moving(_addr(x), x.size, window, _MOVING[stat], _addr(out))
+    return out
+
+
+def analytic(sig):
+    """Analytic signal of a real signal."""
+    x = _real(sig)
+    out = np.empty(x.size, dtype=np.complex128)
+    _lib.dsp_analytic(_addr(x), x.size, _addr(out))
+    return out
+
+
+def analyticFeatures(analyticSig, sampleRate=1.0):
+    """Envelope, instantaneous phase and instantaneous frequency of an analytic signal."""
+    a = _complex(analyticSig)
+    mag = np.empty(a.size)
+    phase = np.empty(a.size)
+    freq = np.empty(a.size)
+    _lib.dsp_analytic_features(_addr(a), a.size, sampleRate, _addr(mag), _addr(phase), _addr(freq))
+    return mag, phase, freq
+
+
+def findPeaks(sig, minProminence=0.0, minDistance=1):
+    """Peak indices and prominences."""
+    x = _real(sig)
+    cap = x.size // 2 + 1
+    index = np.empty(cap, dtype=np.uintp)
+    prominence = np.empty(cap)
+    count = _lib.dsp_find_peaks(_addr(x), x.size, minProminence, minDistance,
+                                _addr(index), _addr(prominence), cap)
+    return index[:count].astype(np.int64), prominence[:count]
@@ -14,4 +14,55 @@ def parseFileAsComplex(filename, path):
     except FileNotFoundError:
         print(f"Error opening file: {filename}")
         return []
-    
\ No newline at end of file
+    
+def parseFileAsRaw(filename, path, dtype='float64'):
+    """
+    Read a raw binary file written by exportToFile_raw, float64 or complex128.
+
+    The samples are read straight into a NumPy array without parsing any text, ready to
+    pass to libdsp as is.
+    """
+    import numpy as np
+    try:
+        return np.fromfile(path + filename, dtype=dtype)
+    except FileNotFoundError:
+        print(f"Error opening file: {filename}")
+        return np.empty(0, dtype=dtype)
+
+def parsePyramid(filename, path, maxPoints=2000, start=0, stop=None):
+    """
+    Read one level of a min/max pyramid written by exportToFile_pyramid.
+
+    Picks the finest level with at most maxPoints bins over samples [start, stop) and
+    reads only those bins. Returns the first sample index of each bin with its min and max.
+    """
+    import numpy as np
+    try:
+        with open(path + filename, 'rb') as f:
+            if f.read(8) != b'DSPPYR01':
+                print(f"Not a pyramid file: {filename}")
+                return [], [], []
+            count, levels = np.fromfile(f, dtype=np.uint64, count=2)
+            header = np.fromfile(f, dtype=np.uint64, count=2 * int(levels)).reshape(-1, 2)
+            dataStart = f.tell()
+            count = int(count)
+            stop = count if stop is None else min(stop, count)
+            if len(header) == 0 or stop <= start:
+                return [], [], []
+
+            # Levels run from finest to coarsest, fall back to the coarsest one
+            offset = dataStart
+            for binSize, bins in header:
+                binSize, bins = int(binSize), int(bins)
+                first = start // binSize
+                last = min((stop + binSize - 1) // binSize, bins)
+                if last - first <= maxPoints or binSize == int(header[-1][0]):
+                    break
+                offset += 16 * bins
+
+            f.seek(offset + 16 * first)
+            pairs = np.fromfile(f, dtype=np.float64, count=2 * (last - first)).reshape(-1, 2)
+            return np.arange(first, last) * binSize, pairs[:, 0], pairs[:, 1]
+    except FileNotFoundError:
+        print(f"Error opening file: {filename}")
+        return [], [], []
@@ -1,13 +1,24 @@
 import matplotlib.pyplot as plt
 import numpy as np
 import argparse
-from parseFile import parseFileAsFloat, parseFileAsComplex
+from parseFile import parseFileAsFloat, parseFileAsComplex, parseFileAsRaw, parsePyramid
+
+# Use the libdsp FFT when the shared library has been built
+try:
+    import libdsp
+except OSError:
+    libdsp = None
 
 def plotSigReal(data):
     # Plot the data
     plt.plot(data)
     plt.show()
     
+# Plot a min/max envelope, one vertical span per bin, so no peak is lost
+def plotSigEnvelope(x, mins, maxs):
+    plt.fill_between(x, mins, maxs, step='post', linewidth=0.5)
+    plt.show()
+
 # Plot the power spectrum
 def plotSigPower(data):
     power = np.abs(data)**2
@@ -16,7 +27,7 @@ def plotSigPower(data):
     
 def plotSigFFT(data):
     # Compute the FFT
-    fft = np.fft.fft(data)
+    fft = libdsp.fft(data) if libdsp else np.fft.fft(data)
     # Perform FFT shift
     fft = np.fft.fftshift(fft)
     # Get the frequency axis
@@ -31,21 +42,31 @@ def plotSigFFT(data):
 if(__name__ == '__main__'):
     parser = argparse.ArgumentParser()
     parser.add_argument('-f', '--filename', help='File name', type=str)
-    parser.add_argument('-t', '--type', help='Data type ("float" or "complex")', type=str, default='float')
+    parser.add_argument('-t', '--type', help='Data type ("float", "complex", "f64", "c128" or "pyramid")', type=str, default='float')
     parser.add_argument('-p', '--path', help='Path to the file', type=str, default='../Data/')
     parser.add_argument('-o', '--output', help='Output file name', type=str, default='output.dat')
     parser.add_argument('-g', '--graph', help='Graph type (real, power, fft)', type=str, default='real')
+    parser.add_argument('-d', '--detail', help='Most bins to load from a pyramid file', type=int, default=2000)
     args = parser.parse_args()
     filename = args.filename
     path = args.path
     type = args.type
     
     data = []
+    # Pyramid files are plotted as an envelope at the requested level of detail
+    if type == 'pyramid':
+        plotSigEnvelope(*parsePyramid(filename, path, args.detail))
+        exit()
     # Parse the file
     if type == 'float':
         data = parseFileAsFloat(filename, path)
     elif type == 'complex':
         data = parseFileAsComplex(filename, path)
+    # Raw binary files load straight into arrays that libdsp uses without conversion
+    elif type == 'f64':
+        data = parseFileAsRaw(filename, path, 'float64')
+    elif type == 'c128':
+        data = parseFileAsRaw(filename, path, 'complex128')
     #plotSigReal(data)
     #plotSigPower(data)
     plotSigFFT(data)
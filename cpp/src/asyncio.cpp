@@ -0,0 +1,718 @@
+#include "asyncio.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <memory>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+namespace
+{
+
+size_t roundToAlign(size_t bytes)
+{
+    bytes = bytes > 0 ? bytes : 1;
+    return (bytes + ASYNC_IO_ALIGN - 1) / ASYNC_IO_ALIGN * ASYNC_IO_ALIGN;
+}
+
+// Open with O_DIRECT if asked and supported, otherwise plain
+int openFile(const std::string& name, int flags, bool& direct)
+{
+#ifdef O_DIRECT
+    if(direct)
+    {
+        int fd = open(name.c_str(), flags | O_DIRECT, 0644);
+        if(fd >= 0)
+        {
+            return fd;
+        }
+    }
+#endif
+    direct = false;
+    return open(name.c_str(), flags, 0644);
+}
+
+// Returns false when not a single buffer could be allocated
+bool allocBuffers(std::vector<char*>& buffers, std::deque<size_t>& freeList, size_t depth, size_t blockSize)
+{
+    buffers.resize(depth < 2 ? 2 : depth);
+    for(size_t i = 0; i < buffers.size(); i++)
+    {
+        void* p = NULL;
+        if(posix_memalign(&p, ASYNC_IO_ALIGN, blockSize) != 0)
+        {
+            p = NULL;
+        }
+        buffers[i] = (char*)p;
+        if(p != NULL)
+        {
+            freeList.push_back(i);
+        }
+    }
+    return !freeList.empty();
+}
+
+
+// Submits positioned reads and writes on one file and reports their completions, with up
+// to depth requests outstanding. Only the owning worker thread calls submit and wait.
+class IoEngine
+{
+public:
+    virtual ~IoEngine() {};
+    // Queue one request, tag comes back with its completion
+    virtual void submit(bool write, char* buf, size_t len, size_t off, size_t tag) = 0;
+    // Block until a request completes, res is the byte count or -errno
+    virtual void wait(size_t& tag, ssize_t& res) = 0;
+};
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+// io_uring through the raw syscalls: every request goes into the submission ring and the
+// kernel keeps them all in flight, no thread blocks per request
+class RingEngine : public IoEngine
+{
+public:
+    RingEngine(int fd) : fd(fd), ringFd(-1), sqPtr(MAP_FAILED), cqPtr(MAP_FAILED), sqePtr(MAP_FAILED) {};
+
+    ~RingEngine()
+    {
+        if(sqePtr != MAP_FAILED)
+        {
+            munmap(sqePtr, sqeLen);
+        }
+        if(cqPtr != MAP_FAILED && cqPtr != sqPtr)
+        {
+            munmap(cqPtr, cqLen);
+        }
+        if(sqPtr != MAP_FAILED)
+        {
+            munmap(sqPtr, sqLen);
+        }
+        if(ringFd >= 0)
+        {
+            ::close(ringFd);
+        }
+    }
+
+    // False when the kernel has no io_uring, refuses it, or lacks IORING_OP_READ/WRITE
+    bool init(unsigned entries)
+    {
+        struct io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        ringFd = (int)syscall(__NR_io_uring_setup, entries, &p);
+        // IORING_FEAT_RW_CUR_POS arrived with IORING_OP_READ and IORING_OP_WRITE
+        if(ringFd < 0 || !(p.features & IORING_FEAT_RW_CUR_POS))
+        {
+            return false;
+        }
+        sqLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqLen = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if(single)
+        {
+            sqLen = cqLen = std::max(sqLen, cqLen);
+        }
+        sqPtr = mmap(NULL, sqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if(sqPtr == MAP_FAILED)
+        {
+            return false;
+        }
+        cqPtr = single ? sqPtr : mmap(NULL, cqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        sqeLen = p.sq_entries * sizeof(struct io_uring_sqe);
+        sqePtr = mmap(NULL, sqeLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if(cqPtr == MAP_FAILED || sqePtr == MAP_FAILED)
+        {
+            return false;
+        }
+        char* sq = (char*)sqPtr;
+        char* cq = (char*)cqPtr;
+        sqTail = (unsigned*)(sq + p.sq_off.tail);
+        sqMask = *(unsigned*)(sq + p.sq_off.ring_mask);
+        sqArray = (unsigned*)(sq + p.sq_off.array);
+        cqHead = (unsigned*)(cq + p.cq_off.head);
+        cqTail = (unsigned*)(cq + p.cq_off.tail);
+        cqMask = *(unsigned*)(cq + p.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+        sqes = (struct io_uring_sqe*)sqePtr;
+        return true;
+    }
+
+    void submit(bool write, char* buf, size_t len, size_t off, size_t tag)
+    {
+        // Without SQPOLL the kernel consumes the entry inside io_uring_enter, so the slot
+        // after the tail is always free
+        const unsigned tail = *sqTail;
+        const unsigned i = tail & sqMask;
+        struct io_uring_sqe* sqe = &sqes[i];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)(uintptr_t)buf;
+        sqe->len = (uint32_t)len;
+        sqe->off = (uint64_t)off;
+        sqe->user_data = (uint64_t)tag;
+        sqArray[i] = i;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        for(;;)
+        {
+            long r = syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, NULL, 0);
+            if(r >= 0)
+            {
+                return;
+            }
+            if(errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                // The entry was not consumed, take it back and fail the request
+                __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+                failedTags.push_back(std::make_pair(tag, (ssize_t)-errno));
+                return;
+            }
+        }
+    }
+
+    void wait(size_t& tag, ssize_t& res)
+    {
+        if(!failedTags.empty())
+        {
+            tag = failedTags.front().first;
+            res = failedTags.front().second;
+            failedTags.pop_front();
+            return;
+        }
+        for(;;)
+        {
+            const unsigned head = *cqHead;
+            if(head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+            {
+                const struct io_uring_cqe* cqe = &cqes[head & cqMask];
+                tag = (size_t)cqe->user_data;
+                res = (ssize_t)cqe->res;
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                return;
+            }
+            syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        }
+    }
+
+private:
+    int fd;
+    int ringFd;
+    void* sqPtr;
+    void* cqPtr;
+    void* sqePtr;
+    size_t sqLen;
+    size_t cqLen;
+    size_t sqeLen;
+    unsigned* sqTail;
+    unsigned sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned cqMask;
+    struct io_uring_cqe* cqes;
+    struct io_uring_sqe* sqes;
+    std::deque<std::pair<size_t, ssize_t> > failedTags;
+};
+#endif
+
+// POSIX fallback: depth I/O threads, each with one blocking pread or pwrite outstanding
+class ThreadEngine : public IoEngine
+{
+public:
+    ThreadEngine(int fd, size_t depth) : fd(fd), stop(false)
+    {
+        for(size_t t = 0; t < depth; t++)
+        {
+            pool.push_back(std::thread(&ThreadEngine::run, this));
+        }
+    }
+
+    ~ThreadEngine()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        requestReady.notify_all();
+        for(size_t t = 0; t < pool.size(); t++)
+        {
+            pool[t].join();
+        }
+    }
+
+    void submit(bool write, char* buf, size_t len, size_t off, size_t tag)
+    {
+        Request r = {write, buf, len, off, tag};
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            requests.push_back(r);
+        }
+        requestReady.notify_one();
+    }
+
+    void wait(size_t& tag, ssize_t& res)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        completionReady.wait(guard, [this] { return !completions.empty(); });
+        tag = completions.front().first;
+        res = completions.front().second;
+        completions.pop_front();
+    }
+
+private:
+    struct Request
+    {
+        bool write;
+        char* buf;
+        size_t len;
+        size_t off;
+        size_t tag;
+    };
+
+    void run()
+    {
+        for(;;)
+        {
+            Request r;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                requestReady.wait(guard, [this] { return stop || !requests.empty(); });
+                if(requests.empty())
+                {
+                    return;
+                }
+                r = requests.front();
+                requests.pop_front();
+            }
+            ssize_t res = r.write ? pwrite(fd, r.buf, r.len, (off_t)r.off) : pread(fd, r.buf, r.len, (off_t)r.off);
+            if(res < 0)
+            {
+                res = -errno;
+            }
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                completions.push_back(std::make_pair(r.tag, res));
+            }
+            completionReady.notify_one();
+        }
+    }
+
+    int fd;
+    bool stop;
+    std::deque<Request> requests;
+    std::deque<std::pair<size_t, ssize_t> > completions;
+    std::mutex lock;
+    std::condition_variable requestReady;
+    std::condition_variable completionReady;
+    std::vector<std::thread> pool;
+};
+
+// io_uring where the kernel allows it, otherwise the thread pool
+std::unique_ptr<IoEngine> makeEngine(int fd, size_t depth)
+{
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+    std::unique_ptr<RingEngine> ring(new RingEngine(fd));
+    if(ring->init((unsigned)depth))
+    {
+        return std::unique_ptr<IoEngine>(ring.release());
+    }
+#endif
+    return std::unique_ptr<IoEngine>(new ThreadEngine(fd, depth));
+}
+
+} // namespace
+
+AsyncReader::AsyncReader
+(
+    const std::string& filename,
+    const std::string& path,
+    size_t blockSize,
+    size_t depth,
+    bool direct
+)
+    : direct(direct),
+      blockSize(roundToAlign(blockSize)),
+      held(-1),
+      done(false),
+      stop(false)
+{
+    fd = openFile(path + filename, O_RDONLY, this->direct);
+    if(fd < 0)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    if(!this->direct)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+    if(!allocBuffers(buffers, freeList, depth, this->blockSize))
+    {
+        printf("Error allocating buffers for file: %s\n", filename.c_str());
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    worker = std::thread(&AsyncReader::run, this);
+}
+
+AsyncReader::~AsyncReader()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+    freeReady.notify_all();
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+    if(fd >= 0)
+    {
+        ::close(fd);
+    }
+    for(size_t i = 0; i < buffers.size(); i++)
+    {
+        free(buffers[i]);
+    }
+}
+
+void AsyncReader::run()
+{
+    std::unique_ptr<IoEngine> io = makeEngine(fd, buffers.size());
+    // Requests in flight in file order, with each buffer's file offset and bytes so far
+    std::deque<size_t> inflight;
+    std::vector<size_t> at(buffers.size(), 0);
+    std::vector<size_t> got(buffers.size(), 0);
+    std::vector<bool> finished(buffers.size(), false);
+    std::vector<bool> failed(buffers.size(), false);
+    size_t nextOffset = 0;
+    bool ended = false;
+
+    for(;;)
+    {
+        // Read ahead into every free buffer
+        std::vector<size_t> issue;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if(inflight.empty())
+            {
+                freeReady.wait(guard, [this, ended] { return stop || ended || !freeList.empty(); });
+                if(stop || ended)
+                {
+                    return;
+                }
+            }
+            while(!stop && !ended && !freeList.empty())
+            {
+                issue.push_back(freeList.front());
+                freeList.pop_front();
+            }
+        }
+        for(size_t i = 0; i < issue.size(); i++)
+        {
+            const size_t idx = issue[i];
+            at[idx] = nextOffset;
+            got[idx] = 0;
+            finished[idx] = false;
+            failed[idx] = false;
+            inflight.push_back(idx);
+            io->submit(false, buffers[idx], blockSize, nextOffset, idx);
+            nextOffset += blockSize;
+        }
+
+        size_t idx;
+        ssize_t r;
+        io->wait(idx, r);
+        if(r > 0)
+        {
+            got[idx] += (size_t)r;
+            // Buffered reads can stop short of the end of the file, finish the block.
+            // O_DIRECT reads are only short at the end, where the rest would be unaligned.
+            if(got[idx] < blockSize && !direct)
+            {
+                io->submit(false, buffers[idx] + got[idx], blockSize - got[idx], at[idx] + got[idx], idx);
+                continue;
+            }
+        }
+        else if(r < 0)
+        {
+            printf("Error reading file at offset %zu: %s\n", at[idx] + got[idx], strerror((int)-r));
+            failed[idx] = true;
+        }
+        finished[idx] = true;
+
+        // Hand over finished blocks in file order; a short block ends the file
+        std::lock_guard<std::mutex> guard(lock);
+        while(!inflight.empty() && finished[inflight.front()])
+        {
+            const size_t b = inflight.front();
+            inflight.pop_front();
+            if(ended || got[b] == 0)
+            {
+                freeList.push_back(b);
+            }
+            else
+            {
+                AsyncBlock block;
+                block.data = buffers[b];
+                block.bytes = got[b];
+                block.offset = at[b];
+                filled.push_back(block);
+                filledIndex.push_back(b);
+            }
+            if(got[b] < blockSize || failed[b])
+            {
+                ended = true;
+                done = true;
+            }
+        }
+        blockReady.notify_all();
+    }
+}
+
+bool AsyncReader::next(AsyncBlock& block)
+{
+    if(fd < 0)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    if(held >= 0)
+    {
+        freeList.push_back((size_t)held);
+        held = -1;
+        freeReady.notify_one();
+    }
+    blockReady.wait(guard, [this] { return done || !filled.empty(); });
+    if(filled.empty())
+    {
+        return false;
+    }
+    block = filled.front();
+    held = (long)filledIndex.front();
+    filled.pop_front();
+    filledIndex.pop_front();
+    return true;
+}
+
+size_t AsyncReader::forEach(const std::function<void(const AsyncBlock&)>& callback)
+{
+    size_t bytes = 0;
+    AsyncBlock block;
+    while(next(block))
+    {
+        callback(block);
+        bytes += block.bytes;
+    }
+    return bytes;
+}
+
+AsyncWriter::AsyncWriter
+(
+    const std::string& filename,
+    const std::string& path,
+    size_t blockSize,
+    size_t depth,
+    bool direct
+)
+    : direct(direct),
+      blockSize(roundToAlign(blockSize)),
+      current(-1),
+      used(0),
+      offset(0),
+      failed(false),
+      stop(false)
+{
+    fd = openFile(path + filename, O_WRONLY | O_CREAT | O_TRUNC, this->direct);
+    if(fd < 0)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return;
+    }
+    if(!allocBuffers(buffers, freeList, depth, this->blockSize))
+    {
+        printf("Error allocating buffers for file: %s\n", filename.c_str());
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    worker = std::thread(&AsyncWriter::run, this);
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    close();
+    for(size_t i = 0; i < buffers.size(); i++)
+    {
+        free(buffers[i]);
+    }
+}
+
+void AsyncWriter::write(const void* data, size_t bytes)
+{
+    if(fd < 0)
+    {
+        return;
+    }
+    const char* src = (const char*)data;
+    while(bytes > 0)
+    {
+        if(current < 0)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            freeReady.wait(guard, [this] { return !freeList.empty(); });
+            current = (long)freeList.front();
+            freeList.pop_front();
+            used = 0;
+        }
+        size_t n = blockSize - used < bytes ? blockSize - used : bytes;
+        memcpy(buffers[current] + used, src, n);
+        used += n;
+        src += n;
+        bytes -= n;
+        if(used == blockSize)
+        {
+            submit();
+        }
+    }
+}
+
+void AsyncWriter::submit()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending.push_back((size_t)current);
+        pendingBytes.push_back(used);
+    }
+    pendingReady.notify_one();
+    current = -1;
+    used = 0;
+}
+
+void AsyncWriter::run()
+{
+    std::unique_ptr<IoEngine> io = makeEngine(fd, buffers.size());
+    // File offset, length and bytes written so far of each buffer in flight
+    std::vector<size_t> at(buffers.size(), 0);
+    std::vector<size_t> want(buffers.size(), 0);
+    std::vector<size_t> put(buffers.size(), 0);
+    size_t inflight = 0;
+
+    // Wait for one write and release its buffer once it is complete
+    auto complete = [&]()
+    {
+        size_t idx;
+        ssize_t r;
+        io->wait(idx, r);
+        if(r > 0)
+        {
+            put[idx] += (size_t)r;
+            if(put[idx] < want[idx])
+            {
+                io->submit(true, buffers[idx] + put[idx], want[idx] - put[idx], at[idx] + put[idx], idx);
+                return;
+            }
+        }
+        else
+        {
+            printf("Error writing file at offset %zu\n", at[idx] + put[idx]);
+            failed = true;
+        }
+        inflight--;
+        std::lock_guard<std::mutex> guard(lock);
+        freeList.push_back(idx);
+        freeReady.notify_one();
+    };
+
+    for(;;)
+    {
+        std::deque<size_t> issue;
+        std::deque<size_t> issueBytes;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if(inflight == 0)
+            {
+                pendingReady.wait(guard, [this] { return stop || !pending.empty(); });
+                if(pending.empty())
+                {
+                    return;
+                }
+            }
+            issue.swap(pending);
+            issueBytes.swap(pendingBytes);
+        }
+
+        for(size_t i = 0; i < issue.size(); i++)
+        {
+            const size_t idx = issue[i];
+#ifdef O_DIRECT
+            // Only the final block can be partial, and O_DIRECT needs whole sectors. The
+            // flag belongs to the open file, so let the direct writes finish first.
+            if(direct && issueBytes[i] < blockSize)
+            {
+                while(inflight > 0)
+                {
+                    complete();
+                }
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+                direct = false;
+            }
+#endif
+            at[idx] = offset;
+            want[idx] = issueBytes[i];
+            put[idx] = 0;
+            offset += issueBytes[i];
+            inflight++;
+            io->submit(true, buffers[idx], issueBytes[i], at[idx], idx);
+        }
+
+        if(inflight > 0)
+        {
+            complete();
+        }
+    }
+}
+
+bool AsyncWriter::close()
+{
+    if(fd < 0)
+    {
+        return false;
+    }
+    if(current >= 0)
+    {
+        if(used > 0)
+        {
+            submit();
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            freeList.push_back((size_t)current);
+            current = -1;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+    pendingReady.notify_all();
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+    ::close(fd);
+    fd = -1;
+    return !failed;
+}
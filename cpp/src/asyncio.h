@@ -0,0 +1,252 @@
+/*************  ✨ Asynchronous File I/O 🌟  *************/
+/**
+ * \file asyncio.h
+ * \brief Double-buffered binary file readers and writers that overlap disk I/O with processing
+ */
+
+#ifndef ASYNCIO_H
+#define ASYNCIO_H
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Alignment of every I/O buffer and of the block size, suitable for O_DIRECT
+ */
+const size_t ASYNC_IO_ALIGN = 4096;
+
+/**
+ * \brief A filled block handed out by AsyncReader
+ */
+struct AsyncBlock
+{
+    /**
+     * \brief Start of the block, aligned to ASYNC_IO_ALIGN
+     */
+    const char* data;
+
+    /**
+     * \brief Number of valid bytes, only the last block of a file is short
+     */
+    size_t bytes;
+
+    /**
+     * \brief Byte offset of the block in the file
+     */
+    size_t offset;
+
+    /**
+     * \brief View the block as samples of type T
+     *
+     * @returns Pointer to the first sample
+     */
+    template <typename T>
+    const T* as() const { return reinterpret_cast<const T*>(data); };
+
+    /**
+     * \brief Count the whole samples of type T in the block
+     *
+     * @returns bytes / sizeof(T)
+     */
+    template <typename T>
+    size_t count() const { return bytes / sizeof(T); };
+};
+
+/**
+ * \brief Sequential file reader with read-ahead
+ *
+ * A background thread keeps a read outstanding on every buffer the consumer is not
+ * holding, so up to depth blocks are in flight while the caller runs convolveFull, DFTs
+ * and so on over the block it holds. Reads go through io_uring where the kernel allows
+ * it, otherwise through depth I/O threads that each have one pread outstanding. Blocks
+ * arrive in file order. The block size is rounded up to ASYNC_IO_ALIGN,
+ * which keeps every block except the last a whole number of samples for any sample type.
+ *
+ * With direct set, the file is opened with O_DIRECT to bypass the page cache. Where the
+ * file system refuses O_DIRECT the reader silently uses buffered reads.
+ */
+class AsyncReader
+{
+public:
+    /**
+     * \brief Constructor for AsyncReader, opens the file and starts reading ahead
+     *
+     * @param filename Name of the file to read
+     * @param path Path to the file
+     * @param blockSize Bytes per block
+     * @param depth Number of blocks in flight, at least 2
+     * @param direct Open with O_DIRECT
+     */
+    AsyncReader
+    (
+        const std::string& filename,
+        const std::string& path,
+        size_t blockSize = 1 << 20,
+        size_t depth = 4,
+        bool direct = false
+    );
+
+    /**
+     * \brief Destructor for AsyncReader, stops the reader thread and closes the file
+     */
+    ~AsyncReader();
+
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+
+    /**
+     * \brief Check that the file was opened and its buffers allocated
+     *
+     * @returns True if the file is open
+     */
+    bool isOpen() const { return fd >= 0; };
+
+    /**
+     * \brief Pull the next block
+     *
+     * The block stays valid until the next call to next(), which returns it to the pool.
+     *
+     * @param block Filled in with the next block
+     *
+     * @return False at the end of the file or on a read error
+     */
+    bool next(AsyncBlock& block);
+
+    /**
+     * \brief Hand every remaining block to a callback, in file order
+     *
+     * @param callback Called once per block
+     *
+     * @return The number of bytes delivered
+     */
+    size_t forEach(const std::function<void(const AsyncBlock&)>& callback);
+
+private:
+    void run();
+
+    int fd;
+    bool direct;
+    size_t blockSize;
+    std::vector<char*> buffers;
+    // Free buffer indices, and filled blocks in file order
+    std::deque<size_t> freeList;
+    std::deque<AsyncBlock> filled;
+    std::deque<size_t> filledIndex;
+    // Buffer held by the consumer, or -1
+    long held;
+    bool done;
+    bool stop;
+    std::mutex lock;
+    std::condition_variable freeReady;
+    std::condition_variable blockReady;
+    std::thread worker;
+};
+
+/**
+ * \brief Sequential file writer with write-behind
+ *
+ * Data is staged into aligned blocks and a background thread submits every full block as
+ * soon as it is staged, so up to depth writes are in flight while the caller keeps
+ * producing. Writes go through io_uring where the kernel allows it, otherwise through
+ * depth I/O threads that each have one pwrite outstanding. write() only blocks when all
+ * depth buffers are waiting on the disk.
+ *
+ * With direct set, the file is opened with O_DIRECT. The final partial block is written
+ * with O_DIRECT switched off, since direct writes must be whole sectors.
+ */
+class AsyncWriter
+{
+public:
+    /**
+     * \brief Constructor for AsyncWriter, creates or truncates the file
+     *
+     * @param filename Name of the file to write
+     * @param path Path to the file
+     * @param blockSize Bytes per block
+     * @param depth Number of blocks in flight, at least 2
+     * @param direct Open with O_DIRECT
+     */
+    AsyncWriter
+    (
+        const std::string& filename,
+        const std::string& path,
+        size_t blockSize = 1 << 20,
+        size_t depth = 4,
+        bool direct = false
+    );
+
+    /**
+     * \brief Destructor for AsyncWriter, flushes and closes the file
+     */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * \brief Check that the file was opened, its buffers allocated and every write so far succeeded
+     *
+     * @returns True if the writer is healthy
+     */
+    bool good() const { return fd >= 0 && !failed; };
+
+    /**
+     * \brief Append bytes to the file
+     *
+     * @param data Bytes to write
+     * @param bytes Number of bytes
+     *
+     * @returns void
+     */
+    void write(const void* data, size_t bytes);
+
+    /**
+     * \brief Append samples to the file
+     *
+     * @param data Samples to write
+     *
+     * @returns void
+     */
+    template <typename T>
+    void write(const std::vector<T>& data) { write(data.data(), data.size() * sizeof(T)); };
+
+    /**
+     * \brief Write out everything staged so far and close the file
+     *
+     * @return True if every write succeeded
+     */
+    bool close();
+
+private:
+    void submit();
+    void run();
+
+    int fd;
+    bool direct;
+    size_t blockSize;
+    std::vector<char*> buffers;
+    std::deque<size_t> freeList;
+    // Buffers waiting for the disk, with their byte counts
+    std::deque<size_t> pending;
+    std::deque<size_t> pendingBytes;
+    // Buffer being staged by the producer, or -1
+    long current;
+    size_t used;
+    size_t offset;
+    // Set by the writer thread, read by good() without the lock
+    std::atomic<bool> failed;
+    bool stop;
+    std::mutex lock;
+    std::condition_variable freeReady;
+    std::condition_variable pendingReady;
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include "baseband.h"
+
+namespace
+{
+
+// Phase accumulator layout: 10 coarse bits, 10 fine bits, 12 truncated bits
+const int NCO_TABLE_BITS = 10;
+const size_t NCO_TABLE_SIZE = (size_t)1 << NCO_TABLE_BITS;
+const int NCO_COARSE_SHIFT = 32 - NCO_TABLE_BITS;
+const int NCO_FINE_SHIFT = 32 - 2 * NCO_TABLE_BITS;
+const uint32_t NCO_ROUND = (uint32_t)1 << (NCO_FINE_SHIFT - 1);
+
+struct NCOTables
+{
+    complex_t coarse[NCO_TABLE_SIZE];
+    complex_t fine[NCO_TABLE_SIZE];
+
+    NCOTables()
+    {
+        for(size_t i = 0; i < NCO_TABLE_SIZE; i++)
+        {
+            double theta = 2.0 * M_PI * (double)i / (double)NCO_TABLE_SIZE;
+            coarse[i] = complex_t(std::cos(theta), std::sin(theta));
+            theta /= (double)NCO_TABLE_SIZE;
+            fine[i] = complex_t(std::cos(theta), std::sin(theta));
+        }
+    }
+};
+
+// Built once, on first use
+const NCOTables& ncoTables()
+{
+    static const NCOTables tables;
+    return tables;
+}
+
+// Convert a phase in cycles to accumulator units, wrapping into [0, 1)
+uint32_t cyclesToPhase(double cycles)
+{
+    cycles -= std::floor(cycles);
+    return (uint32_t)(uint64_t)std::llround(cycles * 4294967296.0);
+}
+
+// Look up e^(j*phase) for an accumulator value
+inline complex_t ncoLookup(const NCOTables& t, uint32_t phase)
+{
+    phase += NCO_ROUND;
+    const complex_t& c = t.coarse[phase >> NCO_COARSE_SHIFT];
+    const complex_t& f = t.fine[(phase >> NCO_FINE_SHIFT) & (NCO_TABLE_SIZE - 1)];
+    return complex_t(c.re * f.re - c.im * f.im, c.re * f.im + c.im * f.re);
+}
+
+} // namespace
+
+NCO::NCO(double freq, double sampleRate, double phase)
+{
+    setFrequency(freq, sampleRate);
+    setPhase(phase);
+}
+
+void NCO::setFrequency(double freq, double sampleRate)
+{
+    phaseInc = cyclesToPhase(freq / sampleRate);
+}
+
+void NCO::setPhase(double phase)
+{
+    phaseAcc = cyclesToPhase(phase / (2.0 * M_PI));
+}
+
+double NCO::getPhase() const
+{
+    return 2.0 * M_PI * (double)phaseAcc / 4294967296.0;
+}
+
+complex_t NCO::next()
+{
+    complex_t out = ncoLookup(ncoTables(), phaseAcc);
+    phaseAcc += phaseInc;
+    return out;
+}
+
+void NCO::generate(std::vector<complex_t>& out)
+{
+    const NCOTables& t = ncoTables();
+    uint32_t phase = phaseAcc;
+    for(size_t i = 0; i < out.size(); i++)
+    {
+        out[i] = ncoLookup(t, phase);
+        phase += phaseInc;
+    }
+    phaseAcc = phase;
+}
+
+void NCO::mix(const std::vector<complex_t>& in, std::vector<complex_t>& out)
+{
+    const NCOTables& t = ncoTables();
+    out.resize(in.size());
+    uint32_t phase = phaseAcc;
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        complex_t lo = ncoLookup(t, phase);
+        double re = in[i].re * lo.re - in[i].im * lo.im;
+        double im = in[i].re * lo.im + in[i].im * lo.re;
+        out[i].re = re;
+        out[i].im = im;
+        phase += phaseInc;
+    }
+    phaseAcc = phase;
+}
+
+void NCO::mix(const std::vector<double>& in, std::vector<complex_t>& out)
+{
+    const NCOTables& t = ncoTables();
+    out.resize(in.size());
+    uint32_t phase = phaseAcc;
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        complex_t lo = ncoLookup(t, phase);
+        out[i].re = in[i] * lo.re;
+        out[i].im = in[i] * lo.im;
+        phase += phaseInc;
+    }
+    phaseAcc = phase;
+}
+
+std::vector<complex_t> freqShift
+(
+    const std::vector<complex_t>& sig,
+    const double shift,
+    const double sampleRate
+)
+{
+    std::vector<complex_t> shifted;
+    NCO nco(shift, sampleRate);
+    nco.mix(sig, shifted);
+    return shifted;
+}
+
+DDC::DDC
+(
+    double centerFreq,
+    double sampleRate,
+    const std::vector<double>& taps,
+    size_t decimation
+)
+    : nco(-centerFreq, sampleRate),
+      ncoInit(nco),
+      revTaps(taps.rbegin(), taps.rend()),
+      decim(decimation > 0 ? decimation : 1)
+{
+    if(revTaps.empty())
+    {
+        revTaps.push_back(1.0);
+    }
+    reset();
+}
+
+void DDC::reset()
+{
+    nco = ncoInit;
+    delay.assign(2 * revTaps.size(), complex_t());
+    pos = 0;
+    decimPhase = 0;
+}
+
+// Mix one input sample down to baseband
+static inline complex_t ddcMix(const complex_t& x, const complex_t& lo)
+{
+    return complex_t(x.re * lo.re - x.im * lo.im, x.re * lo.im + x.im * lo.re);
+}
+
+static inline complex_t ddcMix(const double& x, const complex_t& lo)
+{
+    return complex_t(x * lo.re, x * lo.im);
+}
+
+template <typename T>
+std::vector<complex_t> DDC::run(const std::vector<T>& in)
+{
+    const size_t L = revTaps.size();
+    const double* h = revTaps.data();
+    std::vector<complex_t> out;
+    out.reserve(in.size() / decim + 1);
+
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        // Mix the sample and push it into both halves of the delay line
+        complex_t x = ddcMix(in[i], nco.next());
+        delay[pos] = x;
+        delay[pos + L] = x;
+        pos = (pos + 1 == L) ? 0 : pos + 1;
+
+        // Only evaluate the filter for samples that survive decimation
+        if(decimPhase == 0)
+        {
+            // The oldest sample is now at pos, the newest at pos + L - 1
+            const complex_t* w = delay.data() + pos;
+            double re = 0.0;
+            double im = 0.0;
+            for(size_t k = 0; k < L; k++)
+            {
+                re += h[k] * w[k].re;
+                im += h[k] * w[k].im;
+            }
+            out.push_back(complex_t(re, im));
+        }
+        decimPhase = (decimPhase + 1 == decim) ? 0 : decimPhase + 1;
+    }
+
+    return out;
+}
+
+std::vector<complex_t> DDC::process(const std::vector<complex_t>& in)
+{
+    return run(in);
+}
+
+std::vector<complex_t> DDC::process(const std::vector<double>& in)
+{
+    return run(in);
+}
+
+std::vector<complex_t> downconvert
+(
+    const std::vector<complex_t>& sig,
+    const double centerFreq,
+    const double sampleRate,
+    const std::vector<double>& taps,
+    const size_t decimation
+)
+{
+    DDC ddc(centerFreq, sampleRate, taps, decimation);
+    return ddc.process(sig);
+}
@@ -0,0 +1,208 @@
+/*************  ✨ Complex Baseband Processing 🌟  *************/
+/**
+ * \file baseband.h
+ * \brief Numerically controlled oscillator, frequency shifting and digital down-conversion
+ */
+
+#ifndef BASEBAND_H
+#define BASEBAND_H
+
+#include "libdsp.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \brief Numerically controlled oscillator
+ *
+ * Generates the complex exponential e^(j*2*pi*f*n/fs) without calling any trigonometric
+ * function per sample. The phase is kept in a 32-bit accumulator that wraps naturally
+ * at 2*pi, and each sample is looked up from two 1024 entry tables (coarse and fine
+ * phase) that are combined with a single complex multiply. The phase resolution is
+ * 2*pi/2^20, which keeps the phase truncation spurs below -100 dBc.
+ */
+class NCO
+{
+public:
+    /**
+     * \brief Constructor for NCO
+     *
+     * @param freq Oscillator frequency, may be negative
+     * @param sampleRate Sample rate, in the same units as freq
+     * @param phase Initial phase in radians
+     */
+    NCO(double freq, double sampleRate, double phase = 0.0);
+
+    /**
+     * \brief Change the oscillator frequency without disturbing the phase
+     *
+     * @param freq Oscillator frequency, may be negative
+     * @param sampleRate Sample rate, in the same units as freq
+     *
+     * @returns void
+     */
+    void setFrequency(double freq, double sampleRate);
+
+    /**
+     * \brief Set the current oscillator phase
+     *
+     * @param phase Phase in radians
+     *
+     * @returns void
+     */
+    void setPhase(double phase);
+
+    /**
+     * \brief Access the current oscillator phase
+     *
+     * @returns The phase of the next sample in radians, in the range [0, 2*pi)
+     */
+    double getPhase() const;
+
+    /**
+     * \brief Produce the next oscillator sample and advance the phase
+     *
+     * @returns e^(j*phase)
+     */
+    complex_t next();
+
+    /**
+     * \brief Fill a buffer with consecutive oscillator samples
+     *
+     * @param out Buffer to fill, its size sets the number of samples generated
+     *
+     * @returns void
+     */
+    void generate(std::vector<complex_t>& out);
+
+    /**
+     * \brief Multiply a complex signal by the oscillator
+     *
+     * @param in Input signal
+     * @param out Mixed signal, resized to the length of the input. May alias in.
+     *
+     * @returns void
+     */
+    void mix(const std::vector<complex_t>& in, std::vector<complex_t>& out);
+
+    /**
+     * \brief Multiply a real signal by the oscillator
+     *
+     * @param in Input signal
+     * @param out Mixed signal, resized to the length of the input
+     *
+     * @returns void
+     */
+    void mix(const std::vector<double>& in, std::vector<complex_t>& out);
+
+private:
+    uint32_t phaseAcc;
+    uint32_t phaseInc;
+};
+
+/**
+ * \brief Shift a complex signal in frequency
+ *
+ * @param sig Signal
+ * @param shift Frequency shift, positive values move the spectrum up
+ * @param sampleRate Sample rate, in the same units as shift
+ *
+ * @return The frequency shifted signal
+ */
+std::vector<complex_t> freqShift
+(
+    const std::vector<complex_t>& sig,
+    const double shift,
+    const double sampleRate
+);
+
+/**
+ * \brief Digital down-converter
+ *
+ * Mixes a signal centred at centerFreq down to baseband, low-pass filters it with a real
+ * FIR kernel and decimates the result. The three steps are fused: every input sample is
+ * mixed as it is written into the filter delay line and the FIR is only evaluated for the
+ * samples that survive decimation, so the input is touched exactly once.
+ *
+ * The converter is stateful, so a long signal may be processed in blocks of any size and
+ * the concatenated output is identical to processing it in one call.
+ */
+class DDC
+{
+public:
+    /**
+     * \brief Constructor for DDC
+     *
+     * @param centerFreq Frequency to move to 0 Hz
+     * @param sampleRate Input sample rate, in the same units as centerFreq
+     * @param taps Low-pass FIR kernel
+     * @param decimation Decimation factor, must be at least 1
+     */
+    DDC
+    (
+        double centerFreq,
+        double sampleRate,
+        const std::vector<double>& taps,
+        size_t decimation
+    );
+
+    /**
+     * \brief Down-convert a block of complex samples
+     *
+     * @param in Input block
+     *
+     * @return The decimated baseband samples produced by this block
+     */
+    std::vector<complex_t> process(const std::vector<complex_t>& in);
+
+    /**
+     * \brief Down-convert a block of real samples
+     *
+     * @param in Input block
+     *
+     * @return The decimated baseband samples produced by this block
+     */
+    std::vector<complex_t> process(const std::vector<double>& in);
+
+    /**
+     * \brief Clear the filter history and restart the oscillator and decimator
+     *
+     * @returns void
+     */
+    void reset();
+
+private:
+    template <typename T>
+    std::vector<complex_t> run(const std::vector<T>& in);
+
+    NCO nco;
+    NCO ncoInit;
+    // Taps stored in reverse so the dot product walks the delay line forwards
+    std::vector<double> revTaps;
+    // Delay line written twice so the filter window is always contiguous
+    std::vector<complex_t> delay;
+    size_t pos;
+    size_t decim;
+    size_t decimPhase;
+};
+
+/**
+ * \brief Down-convert a whole signal in one call
+ *
+ * @param sig Signal
+ * @param centerFreq Frequency to move to 0 Hz
+ * @param sampleRate Sample rate, in the same units as centerFreq
+ * @param taps Low-pass FIR kernel
+ * @param decimation Decimation factor, must be at least 1
+ *
+ * @return The decimated baseband signal
+ */
+std::vector<complex_t> downconvert
+(
+    const std::vector<complex_t>& sig,
+    const double centerFreq,
+    const double sampleRate,
+    const std::vector<double>& taps,
+    const size_t decimation
+);
+
+#endif
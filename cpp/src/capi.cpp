@@ -0,0 +1,124 @@
+#include "capi.h"
+#include "libdsp.h"
+#include "detection.h"
+#include "fftplan.h"
+#include "hilbert.h"
+#include "movingstats.h"
+#include "welch.h"
+#include "window.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+
+// Plans are immutable once built, so one per length is shared by every caller
+std::shared_ptr<const FFTPlan> cachedPlan(size_t n)
+{
+    static std::mutex lock;
+    static std::map<size_t, std::shared_ptr<const FFTPlan> > plans;
+    std::lock_guard<std::mutex> guard(lock);
+    std::map<size_t, std::shared_ptr<const FFTPlan> >::iterator it = plans.find(n);
+    if(it != plans.end())
+    {
+        return it->second;
+    }
+    // Keep the cache small when callers sweep many lengths
+    if(plans.size() >= 64)
+    {
+        plans.clear();
+    }
+    std::shared_ptr<const FFTPlan> plan = std::make_shared<const FFTPlan>(n);
+    plans[n] = plan;
+    return plan;
+}
+
+} // namespace
+
+void dsp_fft(complex_t* data, size_t n, int inverse)
+{
+    if(n == 0)
+    {
+        return;
+    }
+    std::shared_ptr<const FFTPlan> plan = cachedPlan(n);
+    if(inverse)
+    {
+        plan->inverse(data);
+    }
+    else
+    {
+        plan->forward(data);
+    }
+}
+
+void dsp_rfft(const double* in, size_t n, complex_t* out)
+{
+    for(size_t i = 0; i < n; i++)
+    {
+        out[i] = complex_t(in[i], 0.0);
+    }
+    dsp_fft(out, n, 0);
+}
+
+void dsp_convolve(const double* sig, size_t n, const double* kernel, size_t k, double* out)
+{
+    convolveFull(sig, n, kernel, k, out);
+}
+
+size_t dsp_welch_psd(const double* sig, size_t n, size_t segment, size_t overlap, int window,
+                     int average, double sampleRate, size_t threads, double* out)
+{
+    // out only holds segment bins, and a signal shorter than one segment has no estimate
+    if(segment == 0 || segment > n)
+    {
+        return 0;
+    }
+    std::vector<double> psd = calcWelchPSD(sig, n, makeWindow((WindowType)window, segment),
+                                           overlap, (WelchAverage)average, sampleRate, threads);
+    const size_t bins = std::min(psd.size(), segment);
+    std::copy(psd.begin(), psd.begin() + bins, out);
+    return bins;
+}
+
+void dsp_moving(const double* sig, size_t n, size_t window, int stat, double* out)
+{
+    switch(stat)
+    {
+        case 0: calcMovingSum(sig, n, window, out); break;
+        case 1: calcMovingMean(sig, n, window, out); break;
+        case 2: calcMovingRMS(sig, n, window, out); break;
+        case 3: calcMovingVar(sig, n, window, out); break;
+        case 4: calcMovingMax(sig, n, window, out); break;
+        case 5: calcMovingMin(sig, n, window, out); break;
+        default: return;
+    }
+}
+
+void dsp_analytic(const double* sig, size_t n, complex_t* out)
+{
+    calcAnalyticSignal(sig, n, out);
+}
+
+void dsp_analytic_features(const complex_t* analytic, size_t n, double sampleRate,
+                           double* magnitude, double* phase, double* frequency)
+{
+    calcAnalyticFeatures(analytic, n, magnitude, phase, frequency, sampleRate);
+}
+
+size_t dsp_find_peaks(const double* sig, size_t n, double minProminence, size_t minDistance,
+                      size_t* index, double* prominence, size_t maxPeaks)
+{
+    std::vector<Peak> peaks = findPeaks(sig, n, minProminence, minDistance);
+    for(size_t i = 0; i < peaks.size() && i < maxPeaks; i++)
+    {
+        index[i] = peaks[i].index;
+        if(prominence != NULL)
+        {
+            prominence[i] = peaks[i].prominence;
+        }
+    }
+    return peaks.size();
+}
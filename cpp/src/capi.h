@@ -0,0 +1,139 @@
+/*************  ✨ C Interface 🌟  *************/
+/**
+ * \file capi.h
+ * \brief Flat C entry points into libdsp for foreign function interfaces such as Python ctypes
+ *
+ * Every function reads from and writes to caller owned buffers, so bindings can pass the
+ * memory of NumPy arrays straight through. Complex buffers are interleaved (re, im) pairs
+ * of doubles, which is both complex_t and NumPy complex128. Output buffers must not
+ * overlap inputs unless a function says otherwise. All functions are thread safe.
+ *
+ * dsp_fft transforms the caller's memory in place. The other functions call the pointer
+ * overloads of the library, which read the input buffers directly and write their results
+ * straight into the output buffers. Only small results are staged: the segment PSD bins
+ * of dsp_welch_psd and the peak list of dsp_find_peaks.
+ */
+
+#ifndef CAPI_H
+#define CAPI_H
+
+#include "complextype.h"
+#include <stddef.h>
+
+using namespace complexDSP;
+
+extern "C"
+{
+
+/**
+ * \brief In-place FFT of any length, plans are cached per length
+ *
+ * @param data n complex samples, replaced by their transform
+ * @param n Transform length
+ * @param inverse Nonzero for the inverse transform, scaled by 1/n
+ *
+ * @returns void
+ */
+void dsp_fft(complex_t* data, size_t n, int inverse);
+
+/**
+ * \brief FFT of a real signal
+ *
+ * @param in n real samples
+ * @param n Transform length
+ * @param out n complex bins
+ *
+ * @returns void
+ */
+void dsp_rfft(const double* in, size_t n, complex_t* out);
+
+/**
+ * \brief Full convolution of a real signal with a real kernel
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param kernel k taps
+ * @param k Kernel length
+ * @param out n + k - 1 samples
+ *
+ * @returns void
+ */
+void dsp_convolve(const double* sig, size_t n, const double* kernel, size_t k, double* out);
+
+/**
+ * \brief Welch power spectral density of a real signal
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param segment Segment length, also the number of output bins. Between 1 and n.
+ * @param overlap Samples shared by consecutive segments
+ * @param window WindowType of each segment
+ * @param average WelchAverage used to combine the segments
+ * @param sampleRate Sample rate
+ * @param threads Worker threads, 0 for one per core
+ * @param out segment PSD bins
+ *
+ * @return The number of bins written, segment on success or 0 when segment is out of
+ *         range and out is left untouched
+ */
+size_t dsp_welch_psd(const double* sig, size_t n, size_t segment, size_t overlap, int window,
+                   int average, double sampleRate, size_t threads, double* out);
+
+/**
+ * \brief Moving statistic over a sliding window
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length
+ * @param stat 0 sum, 1 mean, 2 RMS, 3 variance, 4 max, 5 min
+ * @param out n samples
+ *
+ * @returns void
+ */
+void dsp_moving(const double* sig, size_t n, size_t window, int stat, double* out);
+
+/**
+ * \brief Analytic signal of a real signal
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param out n complex samples
+ *
+ * @returns void
+ */
+void dsp_analytic(const double* sig, size_t n, complex_t* out);
+
+/**
+ * \brief Envelope, phase and instantaneous frequency of an analytic signal
+ *
+ * @param analytic n complex samples
+ * @param n Signal length
+ * @param sampleRate Sample rate
+ * @param magnitude n samples, may be NULL
+ * @param phase n samples, may be NULL
+ * @param frequency n samples, may be NULL
+ *
+ * @returns void
+ */
+void dsp_analytic_features(const complex_t* analytic, size_t n, double sampleRate,
+                           double* magnitude, double* phase, double* frequency);
+
+/**
+ * \brief Find peaks in a signal
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param minProminence Smallest prominence to keep
+ * @param minDistance Smallest index distance between kept peaks
+ * @param index Room for maxPeaks peak indices
+ * @param prominence Room for maxPeaks prominences, may be NULL
+ * @param maxPeaks Capacity of the output buffers
+ *
+ * @return The total number of peaks found, which may exceed maxPeaks
+ */
+size_t dsp_find_peaks(const double* sig, size_t n, double minProminence, size_t minDistance,
+                      size_t* index, double* prominence, size_t maxPeaks);
+
+}
+
+#endif
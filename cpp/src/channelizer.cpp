@@ -0,0 +1,143 @@
+#include "channelizer.h"
+
+Channelizer::Channelizer
+(
+    size_t channels,
+    size_t decimation,
+    const std::vector<double>& prototype,
+    const std::vector<size_t>& select
+)
+    : K(channels > 0 ? channels : 1),
+      D(decimation > 0 ? decimation : 1),
+      plan(K),
+      selected(select)
+{
+    // Pad the prototype to whole polyphase branches and reverse it to match the delay line
+    size_t L = prototype.empty() ? K : (prototype.size() + K - 1) / K * K;
+    hRev.assign(L, 0.0);
+    for(size_t l = 0; l < prototype.size(); l++)
+    {
+        hRev[L - 1 - l] = prototype[l];
+    }
+
+    if(selected.empty())
+    {
+        for(size_t c = 0; c < K; c++)
+        {
+            selected.push_back(c);
+        }
+    }
+    for(size_t i = 0; i < selected.size(); i++)
+    {
+        selected[i] %= K;
+    }
+
+    // A handful of channels is cheaper as direct dot products than as a full FFT
+    size_t log2K = 0;
+    while(((size_t)1 << log2K) < K)
+    {
+        log2K++;
+    }
+    if(selected.size() < K && selected.size() <= log2K)
+    {
+        directTwiddles.resize(selected.size() * K);
+        for(size_t i = 0; i < selected.size(); i++)
+        {
+            for(size_t r = 0; r < K; r++)
+            {
+                size_t q = (selected[i] * r) % K;
+                double theta = 2.0 * M_PI * (double)q / (double)K;
+                directTwiddles[i * K + r] = complex_t(std::cos(theta), -std::sin(theta));
+            }
+        }
+    }
+
+    reset();
+}
+
+void Channelizer::reset()
+{
+    delay.assign(2 * hRev.size(), complex_t());
+    pos = 0;
+    decimPhase = 0;
+    sampleMod = 0;
+}
+
+InterleavedSignal<complex_t> Channelizer::process(const std::vector<complex_t>& in)
+{
+    const size_t L = hRev.size();
+    const size_t C = selected.size();
+    // Outputs fall on the samples where the decimation phase wraps to zero
+    const size_t first = (D - decimPhase) % D;
+    const size_t frames = first < in.size() ? (in.size() - 1 - first) / D + 1 : 0;
+    InterleavedSignal<complex_t> out(C, frames);
+
+    std::vector<complex_t> acc(K);
+    std::vector<complex_t> branch(K);
+    size_t frame = 0;
+
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        delay[pos] = in[i];
+        delay[pos + L] = in[i];
+        pos = (pos + 1 == L) ? 0 : pos + 1;
+
+        if(decimPhase == 0)
+        {
+            // Weight the window by the prototype and fold it onto K polyphase branches
+            const complex_t* w = delay.data() + pos;
+            for(size_t q = 0; q < K; q++)
+            {
+                acc[q] = complex_t();
+            }
+            for(size_t p = 0; p < L; p += K)
+            {
+                const double* h = hRev.data() + p;
+                const complex_t* x = w + p;
+                for(size_t q = 0; q < K; q++)
+                {
+                    acc[q].re += h[q] * x[q].re;
+                    acc[q].im += h[q] * x[q].im;
+                }
+            }
+
+            // Reverse the branches and rotate by the commutator phase of this sample
+            for(size_t r = 0; r < K; r++)
+            {
+                size_t u = (sampleMod + K - r) % K;
+                branch[r] = acc[K - 1 - u];
+            }
+
+            complex_t* y = out.data() + frame * C;
+            if(directTwiddles.empty())
+            {
+                plan.forward(branch.data());
+                for(size_t c = 0; c < C; c++)
+                {
+                    y[c] = branch[selected[c]];
+                }
+            }
+            else
+            {
+                for(size_t c = 0; c < C; c++)
+                {
+                    const complex_t* tw = directTwiddles.data() + c * K;
+                    double re = 0.0;
+                    double im = 0.0;
+                    for(size_t r = 0; r < K; r++)
+                    {
+                        re += branch[r].re * tw[r].re - branch[r].im * tw[r].im;
+                        im += branch[r].re * tw[r].im + branch[r].im * tw[r].re;
+                    }
+                    y[c] = complex_t(re, im);
+                }
+            }
+            frame++;
+        }
+
+        decimPhase = (decimPhase + 1 == D) ? 0 : decimPhase + 1;
+        sampleMod = (sampleMod + 1 == K) ? 0 : sampleMod + 1;
+    }
+
+    return out;
+}
@@ -0,0 +1,91 @@
+/*************  ✨ Polyphase Channelizer 🌟  *************/
+/**
+ * \file channelizer.h
+ * \brief Polyphase FFT filter bank that splits a wideband signal into K channels
+ */
+
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+#include "libdsp.h"
+#include "fftplan.h"
+#include "multichannel.h"
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief Streaming polyphase FFT channelizer
+ *
+ * Splits a complex signal into K channels centred at c * fs / K for c = 0 .. K-1 and
+ * decimates each by D. Channel c is identical to a DDC at c * fs / K with the prototype
+ * filter as its taps, but all K channels together cost one pass over the prototype and
+ * a single K point FFT per output sample instead of K separate mix/filter/decimate runs.
+ *
+ * D == K gives a critically sampled bank. D < K oversamples by K / D, which avoids
+ * aliasing at the channel edges; D should divide K so every output is aligned. The
+ * commutator phase for any D is handled with a circular shift before the FFT.
+ *
+ * When only a few channels are selected they are computed with direct dot products
+ * instead of the full FFT.
+ */
+class Channelizer
+{
+public:
+    /**
+     * \brief Constructor for Channelizer
+     *
+     * @param channels Number of channels K, also the FFT length
+     * @param decimation Output decimation factor D, at least 1
+     * @param prototype Low-pass prototype filter, typically with a cutoff near fs / (2K).
+     *                  It is zero padded to a multiple of K taps.
+     * @param select Channels to emit, in the order they should appear. Empty for all K.
+     */
+    Channelizer
+    (
+        size_t channels,
+        size_t decimation,
+        const std::vector<double>& prototype,
+        const std::vector<size_t>& select = std::vector<size_t>()
+    );
+
+    /**
+     * \brief Channelize a block of samples
+     *
+     * @param in Input block at the wideband sample rate
+     *
+     * @return One frame per output sample and one channel per selected channel
+     */
+    InterleavedSignal<complex_t> process(const std::vector<complex_t>& in);
+
+    /**
+     * \brief Clear the filter history
+     *
+     * @returns void
+     */
+    void reset();
+
+    /**
+     * \brief Access the number of channels emitted per frame
+     *
+     * @returns The number of selected channels
+     */
+    size_t channels() const { return selected.size(); };
+
+private:
+    size_t K;
+    size_t D;
+    FFTPlan plan;
+    // Prototype reversed and padded to a multiple of K taps
+    std::vector<double> hRev;
+    // Delay line written twice so the window is always contiguous
+    std::vector<complex_t> delay;
+    size_t pos;
+    size_t decimPhase;
+    // Input sample index modulo K, sets the commutator shift
+    size_t sampleMod;
+    std::vector<size_t> selected;
+    // Twiddle rows for the direct path, empty when the FFT is used
+    std::vector<complex_t> directTwiddles;
+};
+
+#endif
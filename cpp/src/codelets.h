@@ -0,0 +1,466 @@
+/*************  ✨ Fixed Size DSP Kernels 🌟  *************/
+/**
+ * \file codelets.h
+ * \brief Compile-time specialized FFT and FIR kernels for small, fixed sizes
+ *
+ * The transform size or tap count is a template parameter, so every loop bound is a
+ * constant, twiddle factors and bit-reversal indices are constexpr tables baked into
+ * the binary, and the compiler can fully unroll the butterflies and dot products.
+ * The generic entry points in libdsp.h dispatch here when the runtime size matches.
+ */
+
+#ifndef CODELETS_H
+#define CODELETS_H
+
+#define USE_MATH_DEFINES
+
+#include "complextype.h"
+#include <stddef.h>
+#include <vector>
+#include <math.h>
+
+namespace dspCodelets
+{
+
+/**
+ * \brief Largest FIR tap count handled by a codelet
+ */
+const size_t FIR_CODELET_MAX = 32;
+
+/**
+ * \brief Outputs computed together by the FIR codelets, each with its own accumulator
+ */
+const size_t FIR_BLOCK = 4;
+
+// Compile-time integer sequence, built in logarithmic template depth
+template <size_t... I> struct IndexSeq { typedef IndexSeq type; };
+
+template <typename A, typename B> struct ConcatSeq;
+template <size_t... A, size_t... B>
+struct ConcatSeq<IndexSeq<A...>, IndexSeq<B...> >
+{
+    typedef IndexSeq<A..., (sizeof...(A) + B)...> type;
+};
+
+template <size_t N> struct MakeIndexSeq
+    : ConcatSeq<typename MakeIndexSeq<N / 2>::type, typename MakeIndexSeq<N - N / 2>::type> {};
+template <> struct MakeIndexSeq<0> : IndexSeq<> {};
+template <> struct MakeIndexSeq<1> : IndexSeq<0> {};
+
+// Taylor series sine and cosine, accurate to double precision on [0, pi/2]
+constexpr double ctSinSeries(double x2, double term, double sum, int k)
+{
+    return k == 14 ? sum : ctSinSeries(x2, -term * x2 / ((2.0 * k + 2.0) * (2.0 * k + 3.0)), sum + term, k + 1);
+}
+
+constexpr double ctCosSeries(double x2, double term, double sum, int k)
+{
+    return k == 14 ? sum : ctCosSeries(x2, -term * x2 / ((2.0 * k + 1.0) * (2.0 * k + 2.0)), sum + term, k + 1);
+}
+
+// cos(2*pi*k/N) and sin(2*pi*k/N) for 0 <= k <= N/2, folded onto [0, pi/2]
+constexpr double ctCos(size_t k, size_t N)
+{
+    return 4 * k <= N
+        ? ctCosSeries((2.0 * M_PI * k / N) * (2.0 * M_PI * k / N), 1.0, 0.0, 0)
+        : -ctCosSeries((2.0 * M_PI * (N / 2 - k) / N) * (2.0 * M_PI * (N / 2 - k) / N), 1.0, 0.0, 0);
+}
+
+constexpr double ctSin(size_t k, size_t N)
+{
+    return 4 * k <= N
+        ? ctSinSeries((2.0 * M_PI * k / N) * (2.0 * M_PI * k / N), 2.0 * M_PI * k / N, 0.0, 0)
+        : ctSinSeries((2.0 * M_PI * (N / 2 - k) / N) * (2.0 * M_PI * (N / 2 - k) / N), 2.0 * M_PI * (N / 2 - k) / N, 0.0, 0);
+}
+
+// Reverse the low `bits` bits of i
+constexpr size_t ctBitRev(size_t i, size_t bits)
+{
+    return bits == 0 ? 0 : ((i & 1) << (bits - 1)) | ctBitRev(i >> 1, bits - 1);
+}
+
+constexpr size_t ctLog2(size_t N)
+{
+    return N <= 1 ? 0 : 1 + ctLog2(N / 2);
+}
+
+constexpr bool isPow2(size_t N)
+{
+    return N != 0 && (N & (N - 1)) == 0;
+}
+
+// Forward twiddles e^(-j*2*pi*k/N) for k < N/2
+template <size_t N, typename Seq = typename MakeIndexSeq<N / 2>::type> struct Twiddles;
+template <size_t N, size_t... K>
+struct Twiddles<N, IndexSeq<K...> >
+{
+    static constexpr double re[sizeof...(K)] = { ctCos(K, N)... };
+    static constexpr double im[sizeof...(K)] = { -ctSin(K, N)... };
+};
+template <size_t N, size_t... K>
+constexpr double Twiddles<N, IndexSeq<K...> >::re[sizeof...(K)];
+template <size_t N, size_t... K>
+constexpr double Twiddles<N, IndexSeq<K...> >::im[sizeof...(K)];
+
+// Bit-reversal permutation indices for an N point transform
+template <size_t N, typename Seq = typename MakeIndexSeq<N>::type> struct BitRev;
+template <size_t N, size_t... I>
+struct BitRev<N, IndexSeq<I...> >
+{
+    static constexpr unsigned short idx[sizeof...(I)] = { (unsigned short)ctBitRev(I, ctLog2(N))... };
+};
+template <size_t N, size_t... I>
+constexpr unsigned short BitRev<N, IndexSeq<I...> >::idx[sizeof...(I)];
+
+/**
+ * \brief Radix-2 decimation in time butterflies for an N point transform
+ *
+ * Expects its input in bit-reversed order. Each stage transforms both halves and
+ * combines them with the compile-time twiddles for size N.
+ */
+template <size_t N>
+struct FFTStage
+{
+    static inline void apply(complexDSP::complex_t* d)
+    {
+        FFTStage<N / 2>::apply(d);
+        FFTStage<N / 2>::apply(d + N / 2);
+        typedef Twiddles<N> W;
+        for(size_t k = 0; k < N / 2; k++)
+        {
+            complexDSP::complex_t& a = d[k];
+            complexDSP::complex_t& b = d[k + N / 2];
+            double tr = W::re[k] * b.re - W::im[k] * b.im;
+            double ti = W::re[k] * b.im + W::im[k] * b.re;
+            b.re = a.re - tr;
+            b.im = a.im - ti;
+            a.re += tr;
+            a.im += ti;
+        }
+    }
+};
+
+template <>
+struct FFTStage<1>
+{
+    static inline void apply(complexDSP::complex_t*) {}
+};
+
+template <>
+struct FFTStage<2>
+{
+    static inline void apply(complexDSP::complex_t* d)
+    {
+        double r = d[1].re, i = d[1].im;
+        d[1].re = d[0].re - r;
+        d[1].im = d[0].im - i;
+        d[0].re += r;
+        d[0].im += i;
+    }
+};
+
+template <>
+struct FFTStage<4>
+{
+    static inline void apply(complexDSP::complex_t* d)
+    {
+        // Bit-reversed input: d = {x0, x2, x1, x3}
+        double s0r = d[0].re + d[1].re, s0i = d[0].im + d[1].im;
+        double d0r = d[0].re - d[1].re, d0i = d[0].im - d[1].im;
+        double s1r = d[2].re + d[3].re, s1i = d[2].im + d[3].im;
+        double d1r = d[2].re - d[3].re, d1i = d[2].im - d[3].im;
+        d[0].re = s0r + s1r; d[0].im = s0i + s1i;
+        d[2].re = s0r - s1r; d[2].im = s0i - s1i;
+        // Multiply d1 by -j
+        d[1].re = d0r + d1i; d[1].im = d0i - d1r;
+        d[3].re = d0r - d1i; d[3].im = d0i + d1r;
+    }
+};
+
+// Runtime tap count to compile-time codelet, searched from Taps down to 1
+template <typename T, size_t Taps>
+struct FIRDispatch;
+
+} // namespace dspCodelets
+
+/**
+ * \brief In-place forward FFT of a fixed, power of two size
+ *
+ * Computes X[f] = sum x[s] * e^(-j*2*pi*f*s/N) with input and output in natural order.
+ *
+ * @param data Pointer to N complex samples, overwritten with the transform
+ *
+ * @returns void
+ */
+template <size_t N>
+inline void fft
+(
+    complexDSP::complex_t* data
+)
+{
+    static_assert(dspCodelets::isPow2(N), "fft<N> requires a power of two size");
+    typedef dspCodelets::BitRev<N> R;
+    for(size_t i = 0; i < N; i++)
+    {
+        size_t j = R::idx[i];
+        if(i < j)
+        {
+            complexDSP::complex_t t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+    }
+    dspCodelets::FFTStage<N>::apply(data);
+}
+
+/**
+ * \brief Forward FFT of a fixed, power of two size
+ *
+ * @param sig Signal, must hold at least N samples. Only the first N are used.
+ *
+ * @return The N point DFT of the signal
+ */
+template <size_t N>
+std::vector<complexDSP::complex_t> fft
+(
+    const std::vector<complexDSP::complex_t>& sig
+)
+{
+    std::vector<complexDSP::complex_t> out(sig.begin(), sig.begin() + N);
+    fft<N>(out.data());
+    return out;
+}
+
+/**
+ * \brief Check whether fftCodelet handles a runtime size
+ *
+ * @param N Transform size
+ *
+ * @return True for the powers of two from 2 to 1024
+ */
+inline bool hasFftCodelet
+(
+    const size_t N
+)
+{
+    return N >= 2 && N <= 1024 && dspCodelets::isPow2(N);
+}
+
+/**
+ * \brief Run the FFT codelet matching a runtime size, if there is one
+ *
+ * @param data Pointer to N complex samples, overwritten with the transform
+ * @param N Transform size
+ *
+ * @return True if a codelet handled the transform, false if the caller must fall back
+ */
+inline bool fftCodelet
+(
+    complexDSP::complex_t* data,
+    const size_t N
+)
+{
+    switch(N)
+    {
+        case 2:    fft<2>(data);    return true;
+        case 4:    fft<4>(data);    return true;
+        case 8:    fft<8>(data);    return true;
+        case 16:   fft<16>(data);   return true;
+        case 32:   fft<32>(data);   return true;
+        case 64:   fft<64>(data);   return true;
+        case 128:  fft<128>(data);  return true;
+        case 256:  fft<256>(data);  return true;
+        case 512:  fft<512>(data);  return true;
+        case 1024: fft<1024>(data); return true;
+        default:   return false;
+    }
+}
+
+namespace dspCodelets
+{
+
+// Output m of a full convolution, summing only the taps that overlap the signal
+template <typename T>
+inline T firEdge(const T* sig, size_t n, const T* h, size_t taps, size_t m)
+{
+    const size_t j0 = m >= n ? m - n + 1 : 0;
+    const size_t j1 = m < taps - 1 ? m : taps - 1;
+    T acc = T();
+    for(size_t j = j0; j <= j1; j++)
+    {
+        acc += h[j] * sig[m - j];
+    }
+    return acc;
+}
+
+} // namespace dspCodelets
+
+/**
+ * \brief Full convolution with a fixed number of taps, into a caller owned buffer
+ *
+ * Produces the same output as convolveFull. Interior outputs are computed
+ * FIR_BLOCK at a time: every tap is loaded once per block and feeds FIR_BLOCK
+ * independent accumulators, so the adds do not form one serial dependency chain and the
+ * block vectorizes across outputs. The Taps - 1 outputs at each end, where the kernel
+ * hangs over the signal, are summed directly.
+ *
+ * @param sig n samples
+ * @param n Signal length, at least 1
+ * @param kernel Taps coefficients
+ * @param out n + Taps - 1 samples, must not overlap sig
+ *
+ * @returns void
+ */
+template <size_t Taps, typename T>
+void fir
+(
+    const T* sig,
+    const size_t n,
+    const T* kernel,
+    T* out
+)
+{
+    static_assert(Taps > 0, "fir<Taps> requires at least one tap");
+    const size_t B = dspCodelets::FIR_BLOCK;
+    const size_t total = n + Taps - 1;
+    T h[Taps];
+    for(size_t j = 0; j < Taps; j++)
+    {
+        h[j] = kernel[j];
+    }
+
+    // Outputs where the kernel hangs over the start of the signal
+    size_t m = 0;
+    for(; m < Taps - 1 && m < total; m++)
+    {
+        out[m] = dspCodelets::firEdge(sig, n, h, Taps, m);
+    }
+    for(; m + B <= n; m += B)
+    {
+        T acc[B];
+        for(size_t b = 0; b < B; b++)
+        {
+            acc[b] = T();
+        }
+        for(size_t j = 0; j < Taps; j++)
+        {
+            const T* x = sig + m - j;
+            for(size_t b = 0; b < B; b++)
+            {
+                acc[b] += h[j] * x[b];
+            }
+        }
+        for(size_t b = 0; b < B; b++)
+        {
+            out[m + b] = acc[b];
+        }
+    }
+    // The last partial block and the outputs past the end of the signal
+    for(; m < total; m++)
+    {
+        out[m] = dspCodelets::firEdge(sig, n, h, Taps, m);
+    }
+}
+
+/**
+ * \brief Full convolution with a fixed number of taps
+ *
+ * @param sig Signal, must not be empty
+ * @param kernel Kernel, must hold at least Taps values. Only the first Taps are used.
+ *
+ * @return Convolved signal of length sig.size() + Taps - 1
+ */
+template <size_t Taps, typename T>
+std::vector<T> fir
+(
+    const std::vector<T>& sig,
+    const std::vector<T>& kernel
+)
+{
+    std::vector<T> convolvedSig(sig.size() + Taps - 1);
+    fir<Taps>(sig.data(), sig.size(), kernel.data(), convolvedSig.data());
+    return convolvedSig;
+}
+
+namespace dspCodelets
+{
+
+template <typename T, size_t Taps>
+struct FIRDispatch
+{
+    static bool run(const T* sig, size_t n, const T* kernel, size_t k, T* out)
+    {
+        if(k == Taps)
+        {
+            fir<Taps>(sig, n, kernel, out);
+            return true;
+        }
+        return FIRDispatch<T, Taps - 1>::run(sig, n, kernel, k, out);
+    }
+};
+
+template <typename T>
+struct FIRDispatch<T, 0>
+{
+    static bool run(const T*, size_t, const T*, size_t, T*)
+    {
+        return false;
+    }
+};
+
+} // namespace dspCodelets
+
+/**
+ * \brief Run the FIR codelet matching the kernel length, if there is one
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param kernel k taps
+ * @param k Kernel length
+ * @param out n + k - 1 samples, written only when a codelet was used
+ *
+ * @return True if a codelet handled the convolution, false if the caller must fall back
+ */
+template <typename T>
+bool firCodelet
+(
+    const T* sig,
+    const size_t n,
+    const T* kernel,
+    const size_t k,
+    T* out
+)
+{
+    if(n == 0)
+    {
+        return false;
+    }
+    return dspCodelets::FIRDispatch<T, dspCodelets::FIR_CODELET_MAX>::run(sig, n, kernel, k, out);
+}
+
+/**
+ * \brief Run the FIR codelet matching the kernel length, if there is one
+ *
+ * @param sig Signal
+ * @param kernel Kernel
+ * @param out Convolved signal, written only when a codelet was used
+ *
+ * @return True if a codelet handled the convolution, false if the caller must fall back
+ */
+template <typename T>
+bool firCodelet
+(
+    const std::vector<T>& sig,
+    const std::vector<T>& kernel,
+    std::vector<T>& out
+)
+{
+    if(sig.empty() || kernel.empty() || kernel.size() > dspCodelets::FIR_CODELET_MAX)
+    {
+        return false;
+    }
+    out.resize(sig.size() + kernel.size() - 1);
+    return firCodelet(sig.data(), sig.size(), kernel.data(), kernel.size(), out.data());
+}
+
+#endif
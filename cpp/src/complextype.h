@@ -13,6 +13,7 @@
 #include <math.h>
 #include <cmath>
 #include <stdint.h>
+#include <utility>
 
 namespace complexDSP
 {
@@ -136,7 +137,7 @@ typedef struct complex_type
  * @return The sum of the two complex numbers as a complex_t type
  */
 
-complex_t operator+
+inline complex_t operator+
 (
     const complex_t& a,
     const complex_t& b
@@ -156,7 +157,7 @@ complex_t operator+
  * 
  * @return A reference to the modified complex number `a`
  */
-complex_t& operator+=
+inline complex_t& operator+=
 (
     complex_t& a,
     const complex_t& b
@@ -178,7 +179,7 @@ complex_t& operator+=
  * 
  * @return The difference of the two complex numbers as a complex_t type
  */
-complex_t operator-
+inline complex_t operator-
 (
     const complex_t& a,
     const complex_t& b
@@ -198,7 +199,7 @@ complex_t operator-
  * 
  * @return A reference to the modified complex number `a`
  */
-complex_t& operator-= 
+inline complex_t& operator-= 
 (
     complex_t& a,
     const complex_t& b
@@ -221,7 +222,7 @@ complex_t& operator-=
  * @return The product of the two complex numbers as a complex_t type
  */
 
-complex_t operator*
+inline complex_t operator*
 (
     const complex_t& a,
     const complex_t& b
@@ -241,7 +242,7 @@ complex_t operator*
  * 
  * @return A reference to the modified complex number `a`
  */
-complex_t& operator*=
+inline complex_t& operator*=
 (
     complex_t& a,
     const complex_t& b
@@ -266,7 +267,7 @@ complex_t& operator*=
  * \note The division is performed by multiplying `a` by the conjugate of `b` 
  *       and dividing by the magnitude of `b` squared.
  */
-complex_t operator/
+inline complex_t operator/
 (
     const complex_t& a,
     const complex_t& b
@@ -276,7 +277,7 @@ complex_t operator/
     return {(a.re * b.re + a.im * b.im) / denom, (a.im * b.re - a.re * b.im) / denom};
 }
 
-complex_t& operator/=
+inline complex_t& operator/=
 (
     complex_t& a,
     const complex_t& b
@@ -299,7 +300,7 @@ complex_t& operator/=
  * 
  * @return True if the complex numbers are equal, false otherwise
  */
-const bool operator==
+inline const bool operator==
 (
     const complex_t& a,
     const complex_t& b
@@ -319,7 +320,7 @@ const bool operator==
  * 
  * @return True if the complex numbers are not equal, false otherwise
  */
-const bool operator!=
+inline const bool operator!=
 (
     const complex_t& a,
     const complex_t& b
@@ -341,7 +342,7 @@ const bool operator!=
  * @return True if the magnitude of the first complex number is less than
  * the magnitude of the second complex number, false otherwise
  */
-const bool operator<
+inline const bool operator<
 (
     const complex_t& a,
     const complex_t& b
@@ -363,7 +364,7 @@ const bool operator<
  * @return True if the magnitude of the first complex number is less than
  * or equal to the magnitude of the second complex number, false otherwise
  */
-const bool operator<=
+inline const bool operator<=
 (
     const complex_t& a,
     const complex_t& b
@@ -385,7 +386,7 @@ const bool operator<=
  * @return True if the magnitude of the first complex number is greater than
  *         the magnitude of the second complex number, false otherwise
  */
-const bool operator>
+inline const bool operator>
 (
     const complex_t& a,
     const complex_t& b
@@ -407,7 +408,7 @@ const bool operator>
  * @return True if the magnitude of the first complex number is greater than
  *         or equal to the magnitude of the second complex number, false otherwise
  */
-const bool operator>=
+inline const bool operator>=
 (
     const complex_t& a,
     const complex_t& b
@@ -0,0 +1,162 @@
+#include "decimate.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+
+// Min and max of n samples. Bins are short, so a single pair of select chains (which
+// compile to minsd/maxsd without branches) beats splitting into SIMD lanes and merging.
+inline void minMax(const double* x, size_t n, double& lo, double& hi)
+{
+    double l = x[0];
+    double h = x[0];
+    for(size_t i = 1; i < n; i++)
+    {
+        l = x[i] < l ? x[i] : l;
+        h = x[i] > h ? x[i] : h;
+    }
+    lo = l;
+    hi = h;
+}
+
+} // namespace
+
+std::vector<MinMaxLevel> calcMinMaxPyramid
+(
+    const std::vector<double>& sig,
+    const size_t factor,
+    const size_t minBins
+)
+{
+    std::vector<MinMaxLevel> levels;
+    const size_t N = sig.size();
+    const size_t F = std::max<size_t>(factor, 2);
+    if(N == 0)
+    {
+        return levels;
+    }
+
+    // Level 0 straight from the signal
+    MinMaxLevel base;
+    base.binSize = F;
+    const size_t bins = (N + F - 1) / F;
+    base.min.resize(bins);
+    base.max.resize(bins);
+    for(size_t b = 0; b < bins; b++)
+    {
+        const size_t start = b * F;
+        minMax(sig.data() + start, std::min(F, N - start), base.min[b], base.max[b]);
+    }
+    levels.push_back(std::move(base));
+
+    // Every further level folds factor bins of the previous one
+    while(levels.back().min.size() > std::max<size_t>(minBins, 1))
+    {
+        const MinMaxLevel& prev = levels.back();
+        const size_t prevBins = prev.min.size();
+        MinMaxLevel next;
+        next.binSize = prev.binSize * F;
+        const size_t nextBins = (prevBins + F - 1) / F;
+        next.min.resize(nextBins);
+        next.max.resize(nextBins);
+        for(size_t b = 0; b < nextBins; b++)
+        {
+            const size_t start = b * F;
+            const size_t n = std::min(F, prevBins - start);
+            double lo;
+            double hi;
+            double unused;
+            minMax(prev.min.data() + start, n, lo, unused);
+            minMax(prev.max.data() + start, n, unused, hi);
+            next.min[b] = lo;
+            next.max[b] = hi;
+        }
+        levels.push_back(std::move(next));
+    }
+
+    return levels;
+}
+
+std::vector<size_t> calcLTTB
+(
+    const std::vector<double>& sig,
+    const size_t points
+)
+{
+    const size_t N = sig.size();
+    std::vector<size_t> kept;
+    if(points >= N)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            kept.push_back(i);
+        }
+        return kept;
+    }
+    if(points < 3)
+    {
+        // No room for buckets, keep the end points only
+        if(points > 0)
+        {
+            kept.push_back(0);
+        }
+        if(points > 1)
+        {
+            kept.push_back(N - 1);
+        }
+        return kept;
+    }
+
+    kept.reserve(points);
+    kept.push_back(0);
+    // Buckets between the fixed first and last samples
+    const double every = (double)(N - 2) / (double)(points - 2);
+    size_t a = 0;
+    for(size_t i = 0; i < points - 2; i++)
+    {
+        const size_t start = (size_t)(i * every) + 1;
+        const size_t end = (size_t)((i + 1) * every) + 1;
+
+        // Mean of the next bucket, or the last sample for the final bucket
+        const size_t nextStart = end;
+        const size_t nextEnd = std::min((size_t)((i + 2) * every) + 1, N);
+        double avgX = 0.0;
+        double avgY = 0.0;
+        if(nextStart < nextEnd && i + 3 < points)
+        {
+            for(size_t j = nextStart; j < nextEnd; j++)
+            {
+                avgY += sig[j];
+            }
+            avgX = 0.5 * (double)(nextStart + nextEnd - 1);
+            avgY /= (double)(nextEnd - nextStart);
+        }
+        else
+        {
+            avgX = (double)(N - 1);
+            avgY = sig[N - 1];
+        }
+
+        // Twice the triangle area with the kept point a and the next bucket's mean
+        const double ax = (double)a;
+        const double ay = sig[a];
+        double best = -1.0;
+        size_t pick = start;
+        for(size_t j = start; j < end; j++)
+        {
+            const double area = std::fabs((ax - avgX) * (sig[j] - ay) - (ax - (double)j) * (avgY - ay));
+            if(area > best)
+            {
+                best = area;
+                pick = j;
+            }
+        }
+        kept.push_back(pick);
+        a = pick;
+    }
+    kept.push_back(N - 1);
+
+    return kept;
+}
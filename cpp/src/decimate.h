@@ -0,0 +1,77 @@
+/*************  ✨ Plot Decimation 🌟  *************/
+/**
+ * \file decimate.h
+ * \brief Min/max envelope pyramids and largest-triangle downsampling for plotting long signals
+ */
+
+#ifndef DECIMATE_H
+#define DECIMATE_H
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief One level of a min/max pyramid
+ *
+ * Bin b covers samples [b * binSize, (b + 1) * binSize), the last bin may be shorter.
+ * Drawing a vertical line from min to max for every bin reproduces the plot of the full
+ * signal at that horizontal resolution, peaks included.
+ */
+struct MinMaxLevel
+{
+    /**
+     * \brief Number of signal samples per bin
+     */
+    size_t binSize;
+
+    /**
+     * \brief Smallest sample in each bin
+     */
+    std::vector<double> min;
+
+    /**
+     * \brief Largest sample in each bin
+     */
+    std::vector<double> max;
+};
+
+/**
+ * \brief Build a min/max envelope pyramid
+ *
+ * Level 0 bins factor samples and is the only level that reads the signal. Every further
+ * level merges factor bins of the level below, so the whole pyramid costs one pass over
+ * the signal plus 1 / (factor - 1) of that for the upper levels.
+ *
+ * @param sig Signal
+ * @param factor Bin size of level 0 and the ratio between consecutive levels, at least 2
+ * @param minBins Stop once a level has at most this many bins
+ *
+ * @return The levels from finest to coarsest, empty for an empty signal
+ */
+std::vector<MinMaxLevel> calcMinMaxPyramid
+(
+    const std::vector<double>& sig,
+    const size_t factor = 4,
+    const size_t minBins = 256
+);
+
+/**
+ * \brief Pick samples with the largest-triangle-three-buckets algorithm
+ *
+ * Keeps the first and last samples and one sample from each of points - 2 equal buckets
+ * in between: the one forming the largest triangle with the sample kept from the
+ * previous bucket and the mean of the next bucket. The result follows the visual shape
+ * of the signal as a line plot with only the requested number of points.
+ *
+ * @param sig Signal
+ * @param points Number of samples to keep
+ *
+ * @return Increasing indices of the kept samples, every index when points >= sig.size()
+ */
+std::vector<size_t> calcLTTB
+(
+    const std::vector<double>& sig,
+    const size_t points
+);
+
+#endif
@@ -0,0 +1,383 @@
+#include "detection.h"
+#include "movingstats.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace
+{
+
+// Lowest sample between each index and the nearest strictly higher sample (or the edge)
+// on the side scanned first, found with a monotonic stack in O(N)
+void baseScan(const double* sig, size_t N, bool reverse, std::vector<double>& base)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<size_t> stack;
+    // Minimum over the open gap between each stack entry and the entry above it
+    std::vector<double> gap;
+    double edgeMin = inf;
+    base.resize(N);
+
+    for(size_t n = 0; n < N; n++)
+    {
+        size_t i = reverse ? N - 1 - n : n;
+        double m = inf;
+        while(!stack.empty() && sig[stack.back()] <= sig[i])
+        {
+            m = std::min(m, std::min(sig[stack.back()], gap.back()));
+            stack.pop_back();
+            gap.pop_back();
+        }
+        if(stack.empty())
+        {
+            base[i] = std::min(sig[i], edgeMin);
+        }
+        else
+        {
+            gap.back() = std::min(gap.back(), m);
+            base[i] = std::min(sig[i], gap.back());
+        }
+        stack.push_back(i);
+        gap.push_back(inf);
+        edgeMin = std::min(edgeMin, sig[i]);
+    }
+}
+
+// Noise multiplier for ordered-statistic CFAR: solve
+// pfa = prod_{i=0}^{k-1} (n - i) / (n - i + alpha) for alpha by bisection
+double osScale(size_t n, size_t k, double pfa)
+{
+    double lo = 0.0;
+    double hi = 1.0;
+    for(;;)
+    {
+        double p = 1.0;
+        for(size_t i = 0; i < k; i++)
+        {
+            p *= (double)(n - i) / ((double)(n - i) + hi);
+        }
+        if(p <= pfa || hi > 1e12)
+        {
+            break;
+        }
+        hi *= 2.0;
+    }
+    for(int iter = 0; iter < 200 && hi - lo > 1e-12 * hi; iter++)
+    {
+        double mid = 0.5 * (lo + hi);
+        double p = 1.0;
+        for(size_t i = 0; i < k; i++)
+        {
+            p *= (double)(n - i) / ((double)(n - i) + mid);
+        }
+        if(p > pfa)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return hi;
+}
+
+// Sliding k-th smallest value: the k smallest samples live in low, the rest in high
+class OrderStatistic
+{
+public:
+    void insert(double x)
+    {
+        if(!low.empty() && x <= *low.rbegin())
+        {
+            low.insert(x);
+        }
+        else
+        {
+            high.insert(x);
+        }
+    }
+
+    void erase(double x)
+    {
+        std::multiset<double>::iterator it = low.find(x);
+        if(it != low.end())
+        {
+            low.erase(it);
+        }
+        else
+        {
+            high.erase(high.find(x));
+        }
+    }
+
+    double kth(size_t k)
+    {
+        while(low.size() > k)
+        {
+            std::multiset<double>::iterator last = --low.end();
+            high.insert(*last);
+            low.erase(last);
+        }
+        while(low.size() < k && !high.empty())
+        {
+            low.insert(*high.begin());
+            high.erase(high.begin());
+        }
+        return *low.rbegin();
+    }
+
+private:
+    std::multiset<double> low;
+    std::multiset<double> high;
+};
+
+} // namespace
+
+std::vector<Peak> findPeaks
+(
+    const double* sig,
+    const size_t n,
+    const double minProminence,
+    const size_t minDistance,
+    const double minHeight
+)
+{
+    const size_t N = n;
+    std::vector<Peak> peaks;
+
+    // Local maxima, taking the middle sample of flat tops
+    for(size_t i = 1; i + 1 < N; i++)
+    {
+        if(sig[i - 1] < sig[i])
+        {
+            size_t ahead = i + 1;
+            while(ahead + 1 < N && sig[ahead] == sig[i])
+            {
+                ahead++;
+            }
+            if(sig[ahead] < sig[i] && sig[i] >= minHeight)
+            {
+                Peak p;
+                p.index = (i + ahead - 1) / 2;
+                p.value = sig[i];
+                p.prominence = 0.0;
+                peaks.push_back(p);
+            }
+            i = ahead - 1;
+        }
+    }
+
+    // Spacing: visit peaks from highest to lowest and drop lower neighbours that are too close
+    if(minDistance > 1 && peaks.size() > 1)
+    {
+        std::vector<size_t> order(peaks.size());
+        for(size_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&peaks](size_t a, size_t b)
+        {
+            return peaks[a].value > peaks[b].value;
+        });
+        std::vector<bool> keep(peaks.size(), true);
+        for(size_t n = 0; n < order.size(); n++)
+        {
+            size_t i = order[n];
+            if(!keep[i])
+            {
+                continue;
+            }
+            for(size_t j = i; j > 0 && peaks[i].index - peaks[j - 1].index < minDistance; j--)
+            {
+                keep[j - 1] = false;
+            }
+            for(size_t j = i + 1; j < peaks.size() && peaks[j].index - peaks[i].index < minDistance; j++)
+            {
+                keep[j] = false;
+            }
+        }
+        size_t kept = 0;
+        for(size_t i = 0; i < peaks.size(); i++)
+        {
+            if(keep[i])
+            {
+                peaks[kept++] = peaks[i];
+            }
+        }
+        peaks.resize(kept);
+    }
+
+    // Prominence from the left and right bases
+    std::vector<double> leftBase;
+    std::vector<double> rightBase;
+    baseScan(sig, N, false, leftBase);
+    baseScan(sig, N, true, rightBase);
+    size_t kept = 0;
+    for(size_t i = 0; i < peaks.size(); i++)
+    {
+        size_t idx = peaks[i].index;
+        peaks[i].prominence = sig[idx] - std::max(leftBase[idx], rightBase[idx]);
+        if(peaks[i].prominence >= minProminence)
+        {
+            peaks[kept++] = peaks[i];
+        }
+    }
+    peaks.resize(kept);
+
+    return peaks;
+}
+
+std::vector<Peak> findPeaks
+(
+    const std::vector<double>& sig,
+    const double minProminence,
+    const size_t minDistance,
+    const double minHeight
+)
+{
+    return findPeaks(sig.data(), sig.size(), minProminence, minDistance, minHeight);
+}
+
+CFARDetector::CFARDetector(const CFARConfig& config)
+    : cfg(config)
+{
+    if(cfg.trainingCells == 0)
+    {
+        cfg.trainingCells = 1;
+    }
+    const size_t T = cfg.trainingCells;
+    const size_t n = 2 * T;
+    const size_t k = cfg.rank > 0 ? std::min(cfg.rank, n) : std::max<size_t>((3 * n) / 4, 1);
+
+    // Cells near the edges see fewer training cells, so keep one scale per cell count
+    // to hold the false alarm rate there too
+    scale.assign(n + 1, 0.0);
+    rank.assign(n + 1, 0);
+    for(size_t cells = 1; cells <= n; cells++)
+    {
+        if(cfg.type == CFAR_CELL_AVERAGE)
+        {
+            // Scale on the mean of cells exponential cells
+            scale[cells] = (double)cells * (std::pow(cfg.pfa, -1.0 / (double)cells) - 1.0);
+        }
+        else
+        {
+            // Use the same fraction of the available cells at the edges
+            rank[cells] = std::min(std::max<size_t>((k * cells + T) / n, 1), cells);
+            scale[cells] = osScale(cells, rank[cells], cfg.pfa);
+        }
+    }
+}
+
+std::vector<double> CFARDetector::threshold(const std::vector<double>& power) const
+{
+    const size_t N = power.size();
+    const size_t G = cfg.guardCells;
+    const size_t T = cfg.trainingCells;
+    std::vector<double> thr(N, std::numeric_limits<double>::infinity());
+    if(N == 0)
+    {
+        return thr;
+    }
+
+    if(cfg.type == CFAR_CELL_AVERAGE)
+    {
+        // Left training sum for cell i is the moving sum ending at i - G - 1,
+        // right training sum is the reversed moving sum ending at i + G + 1
+        std::vector<double> fwd = calcMovingSum(power, T);
+        std::vector<double> rev(power.rbegin(), power.rend());
+        rev = calcMovingSum(rev, T);
+        for(size_t i = 0; i < N; i++)
+        {
+            double sum = 0.0;
+            size_t cells = 0;
+            if(i > G)
+            {
+                sum += fwd[i - G - 1];
+                cells += std::min(T, i - G);
+            }
+            if(i + G + 1 < N)
+            {
+                sum += rev[N - 1 - (i + G + 1)];
+                cells += std::min(T, N - 1 - i - G);
+            }
+            if(cells > 0)
+            {
+                thr[i] = scale[cells] * sum / (double)cells;
+            }
+        }
+        return thr;
+    }
+
+    // Ordered statistic: slide both training windows one cell at a time
+    OrderStatistic os;
+    size_t cells = 0;
+    for(size_t j = G + 1; j <= G + T && j < N; j++)
+    {
+        os.insert(power[j]);
+        cells++;
+    }
+    for(size_t i = 0; i < N; i++)
+    {
+        if(cells > 0)
+        {
+            thr[i] = scale[cells] * os.kth(rank[cells]);
+        }
+        // Cell i - G enters the left window and i - G - T leaves it
+        if(i >= G)
+        {
+            os.insert(power[i - G]);
+            cells++;
+        }
+        if(i >= G + T)
+        {
+            os.erase(power[i - G - T]);
+            cells--;
+        }
+        // Cell i + G + 1 leaves the right window and i + G + T + 1 enters it
+        if(i + G + 1 < N)
+        {
+            os.erase(power[i + G + 1]);
+            cells--;
+        }
+        if(i + G + T + 1 < N)
+        {
+            os.insert(power[i + G + T + 1]);
+            cells++;
+        }
+    }
+    return thr;
+}
+
+std::vector<size_t> CFARDetector::detect(const std::vector<double>& power) const
+{
+    std::vector<double> thr = threshold(power);
+    std::vector<size_t> hits;
+    for(size_t i = 0; i < power.size(); i++)
+    {
+        if(power[i] > thr[i])
+        {
+            hits.push_back(i);
+        }
+    }
+    return hits;
+}
+
+std::vector<double> calcCFARThreshold
+(
+    const std::vector<double>& power,
+    const CFARConfig& config
+)
+{
+    return CFARDetector(config).threshold(power);
+}
+
+std::vector<size_t> detectCFAR
+(
+    const std::vector<double>& power,
+    const CFARConfig& config
+)
+{
+    return CFARDetector(config).detect(power);
+}
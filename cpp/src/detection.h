@@ -0,0 +1,195 @@
+/*************  ✨ Peak and CFAR Detection 🌟  *************/
+/**
+ * \file detection.h
+ * \brief Multi-peak search and constant false alarm rate detection over spectra
+ */
+
+#ifndef DETECTION_H
+#define DETECTION_H
+
+#include <stddef.h>
+#include <limits>
+#include <vector>
+
+/**
+ * \brief A local maximum found by findPeaks
+ */
+struct Peak
+{
+    /**
+     * \brief Sample index of the peak, the middle sample for a flat top
+     */
+    size_t index;
+
+    /**
+     * \brief Signal value at the peak
+     */
+    double value;
+
+    /**
+     * \brief Height of the peak above the higher of its two surrounding bases
+     */
+    double prominence;
+};
+
+/**
+ * \brief Find local maxima that satisfy height, prominence and spacing constraints
+ *
+ * Prominence is measured like scipy.signal.peak_prominences: from the peak, walk each
+ * way until a strictly higher sample (or the edge) and take the lowest sample on that
+ * side as its base. All bases are found with one monotonic stack pass in each direction,
+ * so the search is O(N) plus a sort of the surviving peaks for the spacing rule.
+ *
+ * @param sig n samples, typically a magnitude or power spectrum
+ * @param n Signal length
+ * @param minProminence Smallest prominence to keep
+ * @param minDistance Smallest index distance between kept peaks. Where peaks are closer,
+ *                    the higher one wins.
+ * @param minHeight Smallest peak value to keep
+ *
+ * @return The kept peaks in increasing index order
+ */
+std::vector<Peak> findPeaks
+(
+    const double* sig,
+    const size_t n,
+    const double minProminence = 0.0,
+    const size_t minDistance = 1,
+    const double minHeight = -std::numeric_limits<double>::infinity()
+);
+
+/**
+ * \brief Find local maxima that satisfy height, prominence and spacing constraints
+ *
+ * @param sig Signal, typically a magnitude or power spectrum
+ * @param minProminence Smallest prominence to keep
+ * @param minDistance Smallest index distance between kept peaks
+ * @param minHeight Smallest peak value to keep
+ *
+ * @return The kept peaks in increasing index order, see the pointer overload
+ */
+std::vector<Peak> findPeaks
+(
+    const std::vector<double>& sig,
+    const double minProminence = 0.0,
+    const size_t minDistance = 1,
+    const double minHeight = -std::numeric_limits<double>::infinity()
+);
+
+/**
+ * \brief CFAR noise estimator
+ */
+enum CFARType
+{
+    /** Mean of the training cells */
+    CFAR_CELL_AVERAGE,
+    /** k-th smallest training cell, robust to neighbouring targets */
+    CFAR_ORDERED_STATISTIC
+};
+
+/**
+ * \brief CFAR detector settings
+ */
+struct CFARConfig
+{
+    /**
+     * \brief Cells skipped on each side of the cell under test
+     */
+    size_t guardCells = 2;
+
+    /**
+     * \brief Cells averaged on each side, beyond the guard cells
+     */
+    size_t trainingCells = 16;
+
+    /**
+     * \brief Probability of false alarm for exponentially distributed noise power
+     */
+    double pfa = 1e-6;
+
+    /**
+     * \brief Noise estimator
+     */
+    CFARType type = CFAR_CELL_AVERAGE;
+
+    /**
+     * \brief Rank k (1 based) used by CFAR_ORDERED_STATISTIC, 0 for 3/4 of the training cells
+     */
+    size_t rank = 0;
+};
+
+/**
+ * \brief Reusable CFAR detector for a stream of spectra such as spectrogram frames
+ *
+ * The threshold scale is derived from the false alarm rate once at construction, so each
+ * frame only pays for the O(N) sliding window sums (cell averaging) or an O(N log T)
+ * sliding order statistic.
+ *
+ * Cells near the edges use whatever training cells exist on each side. A scale is kept
+ * for every possible training cell count (and, for CFAR_ORDERED_STATISTIC, a rank scaled
+ * to the same fraction of the cells), so the false alarm rate holds at the edges too.
+ */
+class CFARDetector
+{
+public:
+    /**
+     * \brief Constructor for CFARDetector
+     *
+     * @param config Detector settings
+     */
+    explicit CFARDetector(const CFARConfig& config);
+
+    /**
+     * \brief Compute the detection threshold for every cell
+     *
+     * @param power Power spectrum (square law, e.g. |X|^2 or a PSD)
+     *
+     * @return The threshold each cell must exceed
+     */
+    std::vector<double> threshold(const std::vector<double>& power) const;
+
+    /**
+     * \brief Detect cells above the CFAR threshold
+     *
+     * @param power Power spectrum (square law, e.g. |X|^2 or a PSD)
+     *
+     * @return The indices of cells that exceed their threshold
+     */
+    std::vector<size_t> detect(const std::vector<double>& power) const;
+
+private:
+    CFARConfig cfg;
+    // Indexed by the number of training cells, 0 to 2 * trainingCells
+    std::vector<double> scale;
+    std::vector<size_t> rank;
+};
+
+/**
+ * \brief CFAR threshold of a single spectrum
+ *
+ * @param power Power spectrum
+ * @param config Detector settings
+ *
+ * @return The threshold each cell must exceed
+ */
+std::vector<double> calcCFARThreshold
+(
+    const std::vector<double>& power,
+    const CFARConfig& config
+);
+
+/**
+ * \brief CFAR detections in a single spectrum
+ *
+ * @param power Power spectrum
+ * @param config Detector settings
+ *
+ * @return The indices of cells that exceed their threshold
+ */
+std::vector<size_t> detectCFAR
+(
+    const std::vector<double>& power,
+    const CFARConfig& config
+);
+
+#endif
@@ -0,0 +1,162 @@
+#include "fftplan.h"
+
+namespace
+{
+
+bool isPowerOfTwo(size_t N)
+{
+    return N != 0 && (N & (N - 1)) == 0;
+}
+
+} // namespace
+
+FFTPlan::FFTPlan(size_t N)
+    : n(N > 0 ? N : 1)
+{
+    if(isPowerOfTwo(n))
+    {
+        if(n <= 1024)
+        {
+            // fftCodelet covers this length, no tables needed
+            return;
+        }
+        size_t bits = 0;
+        while(((size_t)1 << bits) < n)
+        {
+            bits++;
+        }
+        bitrev.resize(n);
+        for(size_t i = 0; i < n; i++)
+        {
+            size_t r = 0;
+            for(size_t b = 0; b < bits; b++)
+            {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            bitrev[i] = r;
+        }
+        twiddle.resize(n / 2);
+        for(size_t k = 0; k < n / 2; k++)
+        {
+            double theta = 2.0 * M_PI * (double)k / (double)n;
+            twiddle[k] = complex_t(std::cos(theta), -std::sin(theta));
+        }
+        return;
+    }
+
+    // Bluestein: X[k] = c[k] * sum (x[s] c[s]) conj(c[k-s]) with c[s] = e^(-j*pi*s^2/N),
+    // evaluated as a circular convolution of power of two length M >= 2N - 1
+    size_t M = 1;
+    while(M < 2 * n - 1)
+    {
+        M <<= 1;
+    }
+    sub = std::make_shared<FFTPlan>(M);
+    chirp.resize(n);
+    for(size_t s = 0; s < n; s++)
+    {
+        // s^2 mod 2N keeps the angle small and exact
+        size_t q = (size_t)(((unsigned long long)s * s) % (2 * n));
+        double theta = M_PI * (double)q / (double)n;
+        chirp[s] = complex_t(std::cos(theta), -std::sin(theta));
+    }
+    chirpFilter.assign(M, complex_t());
+    chirpFilter[0] = complex_t(chirp[0].re, -chirp[0].im);
+    for(size_t s = 1; s < n; s++)
+    {
+        complex_t c(chirp[s].re, -chirp[s].im);
+        chirpFilter[s] = c;
+        chirpFilter[M - s] = c;
+    }
+    sub->forward(chirpFilter.data());
+}
+
+void FFTPlan::radix2(complex_t* data) const
+{
+    for(size_t i = 0; i < n; i++)
+    {
+        size_t j = bitrev[i];
+        if(i < j)
+        {
+            complex_t t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+    }
+    for(size_t len = 2; len <= n; len <<= 1)
+    {
+        const size_t half = len / 2;
+        const size_t step = n / len;
+        for(size_t start = 0; start < n; start += len)
+        {
+            complex_t* a = data + start;
+            complex_t* b = data + start + half;
+            for(size_t k = 0; k < half; k++)
+            {
+                const complex_t& w = twiddle[k * step];
+                double tr = w.re * b[k].re - w.im * b[k].im;
+                double ti = w.re * b[k].im + w.im * b[k].re;
+                b[k].re = a[k].re - tr;
+                b[k].im = a[k].im - ti;
+                a[k].re += tr;
+                a[k].im += ti;
+            }
+        }
+    }
+}
+
+void FFTPlan::bluestein(complex_t* data) const
+{
+    const FFTPlan& p = *sub;
+    const size_t M = p.size();
+    std::vector<complex_t> a(M);
+    for(size_t s = 0; s < n; s++)
+    {
+        a[s] = complex_t(data[s].re * chirp[s].re - data[s].im * chirp[s].im,
+                         data[s].re * chirp[s].im + data[s].im * chirp[s].re);
+    }
+    p.forward(a.data());
+    for(size_t k = 0; k < M; k++)
+    {
+        const complex_t& b = chirpFilter[k];
+        a[k] = complex_t(a[k].re * b.re - a[k].im * b.im, a[k].re * b.im + a[k].im * b.re);
+    }
+    p.inverse(a.data());
+    for(size_t k = 0; k < n; k++)
+    {
+        data[k] = complex_t(a[k].re * chirp[k].re - a[k].im * chirp[k].im,
+                            a[k].re * chirp[k].im + a[k].im * chirp[k].re);
+    }
+}
+
+void FFTPlan::forward(complex_t* data) const
+{
+    if(!chirp.empty())
+    {
+        bluestein(data);
+    }
+    else if(!bitrev.empty())
+    {
+        radix2(data);
+    }
+    else
+    {
+        fftCodelet(data, n);
+    }
+}
+
+void FFTPlan::inverse(complex_t* data) const
+{
+    // ifft(X) = conj(fft(conj(X))) / N
+    for(size_t i = 0; i < n; i++)
+    {
+        data[i].im = -data[i].im;
+    }
+    forward(data);
+    const double scale = 1.0 / (double)n;
+    for(size_t i = 0; i < n; i++)
+    {
+        data[i].re *= scale;
+        data[i].im *= -scale;
+    }
+}
@@ -0,0 +1,74 @@
+/*************  ✨ Reusable FFT Plans 🌟  *************/
+/**
+ * \file fftplan.h
+ * \brief Precomputed forward and inverse FFTs of a fixed, arbitrary length
+ */
+
+#ifndef FFTPLAN_H
+#define FFTPLAN_H
+
+#include "libdsp.h"
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief A forward/inverse FFT of one length, with all tables computed up front
+ *
+ * Power of two lengths up to 1024 run the compile-time codelets, larger powers of two
+ * an iterative radix-2 transform, and any other length uses Bluestein's algorithm on
+ * top of a power of two plan, so every length costs O(N log N).
+ *
+ * A plan is read-only once built and may be shared between threads, as long as each
+ * thread transforms its own buffer.
+ */
+class FFTPlan
+{
+public:
+    /**
+     * \brief Constructor for FFTPlan
+     *
+     * @param N Transform length, must be at least 1
+     */
+    explicit FFTPlan(size_t N);
+
+    /**
+     * \brief Access the transform length
+     *
+     * @returns The number of points
+     */
+    size_t size() const { return n; };
+
+    /**
+     * \brief In-place forward transform, X[f] = sum x[s] * e^(-j*2*pi*f*s/N)
+     *
+     * @param data Pointer to N complex samples
+     *
+     * @returns void
+     */
+    void forward(complex_t* data) const;
+
+    /**
+     * \brief In-place inverse transform, x[s] = 1/N * sum X[f] * e^(+j*2*pi*f*s/N)
+     *
+     * @param data Pointer to N complex samples
+     *
+     * @returns void
+     */
+    void inverse(complex_t* data) const;
+
+private:
+    void radix2(complex_t* data) const;
+    void bluestein(complex_t* data) const;
+
+    size_t n;
+    // Radix-2 tables, empty when the length is handled by a codelet or Bluestein
+    std::vector<complex_t> twiddle;
+    std::vector<size_t> bitrev;
+    // Bluestein chirp and the transformed conjugate chirp filter
+    std::vector<complex_t> chirp;
+    std::vector<complex_t> chirpFilter;
+    std::shared_ptr<const FFTPlan> sub;
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include <complex>
 #include <vector>
+#include "multichannel.h"
+#include "fixedpoint.h"
+#include "decimate.h"
 
 /**
  * \brief Parse a file and return its contents as a vector of floating point values or complex IQ values
@@ -118,4 +121,265 @@ void exportToFile_c(std::vector<std::complex<double>> data, std::string filename
     }
     
     fclose(fp);
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Parse a multi-channel file into an interleaved signal
+ * 
+ * The file holds one frame per line with the channels separated by commas, as written by
+ * exportToFile_mc. A trailing partial frame is dropped.
+ * 
+ * @param filename Name of the file to parse
+ * @param path Path to the file
+ * @param channels Number of channels per frame
+ * 
+ * @return Interleaved signal with one frame per line of the file
+ */
+InterleavedSignal<double> parseFile_mc(std::string filename, std::string path, size_t channels)
+{
+    FILE *fp = fopen((path + filename).c_str(), "r");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return InterleavedSignal<double>(channels, 0);
+    }
+
+    std::vector<double> data;
+    // Parse every value in file order, skipping the commas between channels
+    double value;
+    while (fscanf(fp, "%lf", &value) == 1)
+    {
+        data.push_back(value);
+        if (fscanf(fp, " ,") == EOF)
+        {
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    return InterleavedSignal<double>(channels, std::move(data));
+}
+
+/**
+ * \brief Write an interleaved signal to a file, one frame per line
+ * 
+ * @param data Interleaved signal to write to the file
+ * @param filename Name of the file to write to
+ * @param path Path to the file
+ * 
+ * @return void
+ */
+void exportToFile_mc(const InterleavedSignal<double>& data, std::string filename, std::string path)
+{
+    FILE *fp = fopen((path + filename).c_str(), "w");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return;
+    }
+
+    // Write each frame as comma separated channel values
+    const double* x = data.data();
+    for (size_t n = 0; n < data.frames(); n++)
+    {
+        for (size_t c = 0; c < data.channels(); c++)
+        {
+            fprintf(fp, c + 1 < data.channels() ? "%lf," : "%lf\n", *x++);
+        }
+    }
+
+    fclose(fp);
+}
+
+/**
+ * \brief Read a raw binary file of native endian integer samples
+ * 
+ * @param filename Name of the file to parse
+ * @param path Path to the file
+ * 
+ * @return Vector of samples, a trailing partial sample is dropped
+ */
+template <typename T>
+std::vector<T> parseFile_raw(std::string filename, std::string path)
+{
+    FILE *fp = fopen((path + filename).c_str(), "rb");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return std::vector<T>();
+    }
+
+    // Size the buffer from the file length and read it in one call
+    fseek(fp, 0, SEEK_END);
+    long bytes = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    std::vector<T> data(bytes > 0 ? (size_t)bytes / sizeof(T) : 0);
+    data.resize(fread(data.data(), sizeof(T), data.size(), fp));
+
+    fclose(fp);
+
+    return data;
+}
+
+/**
+ * \brief Write samples to a raw binary file, native endian with no header
+ * 
+ * A vector of double matches NumPy float64 and a vector of complex_t matches NumPy
+ * complex128, so the file loads with np.fromfile without parsing any text.
+ * 
+ * @param data Samples to write
+ * @param filename Name of the file to write to
+ * @param path Path to the file
+ * 
+ * @return void
+ */
+template <typename T>
+void exportToFile_raw(const std::vector<T>& data, std::string filename, std::string path)
+{
+    FILE *fp = fopen((path + filename).c_str(), "wb");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return;
+    }
+
+    if(fwrite(data.data(), sizeof(T), data.size(), fp) != data.size())
+    {
+        printf("Error writing file: %s\n", filename.c_str());
+    }
+
+    fclose(fp);
+}
+
+/**
+ * \brief Read a raw binary file of int16 samples
+ * 
+ * @param filename Name of the file to parse
+ * @param path Path to the file
+ * 
+ * @return Vector of int16 samples
+ */
+std::vector<int16_t> parseFile_i16(std::string filename, std::string path)
+{
+    return parseFile_raw<int16_t>(filename, path);
+}
+
+/**
+ * \brief Read a raw binary file of int32 samples
+ * 
+ * @param filename Name of the file to parse
+ * @param path Path to the file
+ * 
+ * @return Vector of int32 samples
+ */
+std::vector<int32_t> parseFile_i32(std::string filename, std::string path)
+{
+    return parseFile_raw<int32_t>(filename, path);
+}
+
+/**
+ * \brief Read a raw binary file of interleaved int16 IQ samples directly into complex_t
+ * 
+ * The file is read in fixed size chunks that are converted and scaled straight into the
+ * output, so the full capture is never held as both integers and doubles.
+ * 
+ * @param filename Name of the file to parse
+ * @param path Path to the file
+ * @param scale Factor applied to every component, defaults to Q15 scaling
+ * 
+ * @return Vector of complex IQ values
+ */
+std::vector<complex_t> parseFile_iq16(std::string filename, std::string path, double scale = Q15_SCALE)
+{
+    FILE *fp = fopen((path + filename).c_str(), "rb");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return std::vector<complex_t>();
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long bytes = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    std::vector<complex_t> data(bytes > 0 ? (size_t)bytes / (2 * sizeof(int16_t)) : 0);
+
+    // Convert one chunk of IQ pairs at a time
+    const size_t chunkPairs = 32768;
+    std::vector<int16_t> chunk(2 * chunkPairs);
+    size_t done = 0;
+    while (done < data.size())
+    {
+        size_t want = std::min(chunkPairs, data.size() - done);
+        size_t got = fread(chunk.data(), 2 * sizeof(int16_t), want, fp);
+        convertIQScaled(chunk.data(), got, scale, data.data() + done);
+        done += got;
+        if (got < want)
+        {
+            break;
+        }
+    }
+    data.resize(done);
+
+    fclose(fp);
+
+    return data;
+}
+/**
+ * \brief Write a min/max pyramid of a signal for plotting
+ * 
+ * Binary layout, all native endian: the 8 characters "DSPPYR01", uint64 sample count,
+ * uint64 level count, then uint64 binSize and uint64 bin count for every level, then
+ * every level's bins as interleaved float64 (min, max) pairs, finest level first. A
+ * plotter can seek straight to the coarsest level that still fills its view instead of
+ * loading the whole signal.
+ * 
+ * @param data Signal to summarize
+ * @param filename Name of the file to write to
+ * @param path Path to the file
+ * @param factor Bin size of the finest level and the ratio between levels
+ * @param minBins Bin count at which the pyramid stops
+ * 
+ * @return void
+ */
+void exportToFile_pyramid(const std::vector<double>& data, std::string filename, std::string path, size_t factor = 4, size_t minBins = 256)
+{
+    FILE *fp = fopen((path + filename).c_str(), "wb");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", filename.c_str());
+        return;
+    }
+
+    std::vector<MinMaxLevel> levels = calcMinMaxPyramid(data, factor, minBins);
+    std::vector<uint64_t> header;
+    header.push_back(data.size());
+    header.push_back(levels.size());
+    for (size_t l = 0; l < levels.size(); l++)
+    {
+        header.push_back(levels[l].binSize);
+        header.push_back(levels[l].min.size());
+    }
+    fwrite("DSPPYR01", 1, 8, fp);
+    fwrite(header.data(), sizeof(uint64_t), header.size(), fp);
+
+    // Interleave each level's min and max a block at a time
+    std::vector<double> pairs;
+    for (size_t l = 0; l < levels.size(); l++)
+    {
+        const size_t bins = levels[l].min.size();
+        for (size_t b = 0; b < bins; b += 4096)
+        {
+            size_t n = std::min<size_t>(4096, bins - b);
+            pairs.resize(2 * n);
+            for (size_t i = 0; i < n; i++)
+            {
+                pairs[2 * i] = levels[l].min[b + i];
+                pairs[2 * i + 1] = levels[l].max[b + i];
+            }
+            fwrite(pairs.data(), sizeof(double), pairs.size(), fp);
+        }
+    }
+
+    fclose(fp);
+}
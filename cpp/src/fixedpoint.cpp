@@ -0,0 +1,102 @@
+#include "fixedpoint.h"
+#include <algorithm>
+
+namespace
+{
+
+// Round a Q30 accumulator to Q15 and clamp it to the representable range
+inline q15_t saturateQ30(int64_t acc)
+{
+    acc = (acc + (1 << 14)) >> 15;
+    return (q15_t)std::min<int64_t>(std::max<int64_t>(acc, -32768), 32767);
+}
+
+// alpha = 0.96043387 and beta = 0.39782473 in Q15
+const int32_t MAG_ALPHA_Q15 = 31471;
+const int32_t MAG_BETA_Q15 = 13036;
+
+} // namespace
+
+std::vector<q15_t> toQ15
+(
+    const std::vector<double>& sig
+)
+{
+    std::vector<q15_t> out(sig.size());
+    for(size_t i = 0; i < sig.size(); i++)
+    {
+        double v = std::floor(sig[i] * 32768.0 + 0.5);
+        out[i] = (q15_t)std::min(std::max(v, -32768.0), 32767.0);
+    }
+    return out;
+}
+
+std::vector<q15_t> convolveFullQ15
+(
+    const std::vector<q15_t>& sig,
+    const std::vector<q15_t>& kernel
+)
+{
+    if(sig.empty() || kernel.empty())
+    {
+        return std::vector<q15_t>();
+    }
+
+    const size_t K = kernel.size();
+    std::vector<q15_t> rev(kernel.rbegin(), kernel.rend());
+    // Zero pad so every output is a dot product of K contiguous samples
+    std::vector<q15_t> padded(sig.size() + 2 * (K - 1), 0);
+    std::copy(sig.begin(), sig.end(), padded.begin() + (K - 1));
+
+    std::vector<q15_t> out(sig.size() + K - 1);
+    for(size_t n = 0; n < out.size(); n++)
+    {
+        const q15_t* w = padded.data() + n;
+        int64_t acc = 0;
+        for(size_t k = 0; k < K; k++)
+        {
+            acc += (int32_t)w[k] * (int32_t)rev[k];
+        }
+        out[n] = saturateQ30(acc);
+    }
+    return out;
+}
+
+std::vector<int32_t> calcMagSqQ15
+(
+    const std::vector<q15_t>& iq
+)
+{
+    const size_t N = iq.size() / 2;
+    std::vector<int32_t> out(N);
+    for(size_t i = 0; i < N; i++)
+    {
+        int32_t re = iq[2 * i];
+        int32_t im = iq[2 * i + 1];
+        // Only (-32768)^2 + (-32768)^2 overflows, clamp it
+        uint32_t sq = (uint32_t)(re * re) + (uint32_t)(im * im);
+        out[i] = (int32_t)std::min<uint32_t>(sq, 0x7FFFFFFF);
+    }
+    return out;
+}
+
+std::vector<q15_t> calcMagQ15
+(
+    const std::vector<q15_t>& iq
+)
+{
+    const size_t N = iq.size() / 2;
+    std::vector<q15_t> out(N);
+    for(size_t i = 0; i < N; i++)
+    {
+        int32_t re = iq[2 * i];
+        int32_t im = iq[2 * i + 1];
+        re = re < 0 ? -re : re;
+        im = im < 0 ? -im : im;
+        int32_t hi = std::max(re, im);
+        int32_t lo = std::min(re, im);
+        int32_t mag = (hi * MAG_ALPHA_Q15 + lo * MAG_BETA_Q15 + (1 << 14)) >> 15;
+        out[i] = (q15_t)std::min(mag, (int32_t)32767);
+    }
+    return out;
+}
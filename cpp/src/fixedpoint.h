@@ -0,0 +1,233 @@
+/*************  ✨ Fixed Point Samples 🌟  *************/
+/**
+ * \file fixedpoint.h
+ * \brief Integer sample conversion and Q15 fixed point FIR and magnitude kernels
+ *
+ * Raw captures are usually 16-bit integers. These routines convert them straight into
+ * the floating point or complex_t buffers the rest of the library uses, applying the
+ * scale factor in the same pass, and provide Q15 kernels for stages where integer math
+ * is precise enough.
+ */
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include "libdsp.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * \brief Q15 fixed point sample: 1 sign bit, 15 fractional bits, range [-1, 1)
+ */
+typedef int16_t q15_t;
+
+/**
+ * \brief Scale factor from Q15 to floating point
+ */
+const double Q15_SCALE = 1.0 / 32768.0;
+
+namespace dspFixed
+{
+
+// Converts a leading run of samples with SIMD and returns how many it handled. Only the
+// overloads below do any work, every other type pair is left to the scalar loop.
+template <typename In, typename Out>
+inline size_t convertScaledSIMD(const In*, size_t, Out, Out*)
+{
+    return 0;
+}
+
+#ifdef __SSE2__
+// Eight int16 per step: sign extend to int32 by unpacking each value into the high half
+// of a lane and shifting it back down, then convert pairs to double and scale
+inline size_t convertScaledSIMD(const int16_t* in, size_t n, double scale, double* out)
+{
+    const __m128d k = _mm_set1_pd(scale);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_cvtepi32_pd(lo), k));
+        _mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(lo, 0xEE)), k));
+        _mm_storeu_pd(out + i + 4, _mm_mul_pd(_mm_cvtepi32_pd(hi), k));
+        _mm_storeu_pd(out + i + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(hi, 0xEE)), k));
+    }
+    return i;
+}
+
+// Four int32 per step, converted to double two at a time
+inline size_t convertScaledSIMD(const int32_t* in, size_t n, double scale, double* out)
+{
+    const __m128d k = _mm_set1_pd(scale);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_cvtepi32_pd(v), k));
+        _mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(v, 0xEE)), k));
+    }
+    return i;
+}
+#endif
+
+} // namespace dspFixed
+
+/**
+ * \brief Convert integer samples to floating point and scale them in one pass
+ *
+ * int16 and int32 to double use SSE2 where the target has it, so the conversion does not
+ * depend on the optimizer or flags of the translation unit including this header. Results
+ * are identical to the scalar loop, which handles the remaining samples and other types.
+ *
+ * @param in Integer samples
+ * @param n Number of samples
+ * @param scale Factor applied to every sample
+ * @param out Output buffer of at least n samples
+ *
+ * @returns void
+ */
+template <typename In, typename Out>
+void convertScaled
+(
+    const In* in,
+    const size_t n,
+    const Out scale,
+    Out* out
+)
+{
+    for(size_t i = dspFixed::convertScaledSIMD(in, n, scale, out); i < n; i++)
+    {
+        out[i] = (Out)in[i] * scale;
+    }
+}
+
+/**
+ * \brief Convert interleaved integer IQ pairs to complex_t and scale them in one pass
+ *
+ * complex_t is laid out as two adjacent doubles, so this is a single flat conversion
+ * over 2 * pairs values.
+ *
+ * @param iq Interleaved I, Q samples
+ * @param pairs Number of IQ pairs
+ * @param scale Factor applied to every component
+ * @param out Output buffer of at least pairs values
+ *
+ * @returns void
+ */
+template <typename In>
+void convertIQScaled
+(
+    const In* iq,
+    const size_t pairs,
+    const double scale,
+    complex_t* out
+)
+{
+    static_assert(sizeof(complex_t) == 2 * sizeof(double), "complex_t must be two packed doubles");
+    convertScaled(iq, 2 * pairs, scale, reinterpret_cast<double*>(out));
+}
+
+/**
+ * \brief Convert a vector of integer samples to scaled doubles
+ *
+ * @param sig Integer samples
+ * @param scale Factor applied to every sample
+ *
+ * @return The scaled samples
+ */
+template <typename In>
+std::vector<double> toDouble
+(
+    const std::vector<In>& sig,
+    const double scale
+)
+{
+    std::vector<double> out(sig.size());
+    convertScaled(sig.data(), sig.size(), scale, out.data());
+    return out;
+}
+
+/**
+ * \brief Convert a vector of interleaved integer IQ samples to scaled complex values
+ *
+ * @param iq Interleaved I, Q samples, a trailing unpaired value is ignored
+ * @param scale Factor applied to every component
+ *
+ * @return The scaled complex samples
+ */
+template <typename In>
+std::vector<complex_t> toComplex
+(
+    const std::vector<In>& iq,
+    const double scale
+)
+{
+    std::vector<complex_t> out(iq.size() / 2);
+    convertIQScaled(iq.data(), out.size(), scale, out.data());
+    return out;
+}
+
+/**
+ * \brief Convert doubles to Q15 with rounding and saturation
+ *
+ * @param sig Samples, nominally in [-1, 1)
+ *
+ * @return The Q15 samples
+ */
+std::vector<q15_t> toQ15
+(
+    const std::vector<double>& sig
+);
+
+/**
+ * \brief Full convolution of Q15 samples with a Q15 kernel
+ *
+ * Products are accumulated at full precision, then rounded back to Q15 and saturated,
+ * so the result matches convolveFull on the dequantized inputs to within one LSB
+ * unless it clips.
+ *
+ * @param sig Q15 signal
+ * @param kernel Q15 kernel
+ *
+ * @return Q15 convolved signal of length sig.size() + kernel.size() - 1
+ */
+std::vector<q15_t> convolveFullQ15
+(
+    const std::vector<q15_t>& sig,
+    const std::vector<q15_t>& kernel
+);
+
+/**
+ * \brief Squared magnitude of interleaved Q15 IQ samples
+ *
+ * @param iq Interleaved I, Q samples in Q15
+ *
+ * @return I*I + Q*Q for each pair, exact, in Q30
+ */
+std::vector<int32_t> calcMagSqQ15
+(
+    const std::vector<q15_t>& iq
+);
+
+/**
+ * \brief Approximate magnitude of interleaved Q15 IQ samples
+ *
+ * Uses the alpha max plus beta min estimate, which needs no square root or division and
+ * has a peak error of about 4%. Results saturate at the largest Q15 value.
+ *
+ * @param iq Interleaved I, Q samples in Q15
+ *
+ * @return The magnitude of each pair, in Q15
+ */
+std::vector<q15_t> calcMagQ15
+(
+    const std::vector<q15_t>& iq
+);
+
+#endif
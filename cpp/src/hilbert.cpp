@@ -0,0 +1,227 @@
+#include "hilbert.h"
+#include "fftplan.h"
+
+namespace
+{
+
+// Envelope, phase and phase step of n analytic samples; prev is the sample before a[0]
+void featuresInto
+(
+    const complex_t* a,
+    size_t n,
+    complex_t prev,
+    double sampleRate,
+    bool fast,
+    double* mag,
+    double* phase,
+    double* freq
+)
+{
+    const double toHz = sampleRate / (2.0 * M_PI);
+    for(size_t i = 0; i < n; i++)
+    {
+        const double re = a[i].re;
+        const double im = a[i].im;
+        // a[i] * conj(a[i-1]) rotates by the phase step without any unwrapping
+        const double dre = re * prev.re + im * prev.im;
+        const double dim = im * prev.re - re * prev.im;
+        mag[i] = std::sqrt(re * re + im * im);
+        if(fast)
+        {
+            phase[i] = fastAtan2(im, re);
+            freq[i] = fastAtan2(dim, dre) * toHz;
+        }
+        else
+        {
+            phase[i] = std::atan2(im, re);
+            freq[i] = std::atan2(dim, dre) * toHz;
+        }
+        prev = a[i];
+    }
+}
+
+} // namespace
+
+void calcAnalyticSignal
+(
+    const double* sig,
+    const size_t n,
+    complex_t* out
+)
+{
+    const size_t N = n;
+    if(N == 0)
+    {
+        return;
+    }
+    for(size_t i = 0; i < N; i++)
+    {
+        out[i] = complex_t(sig[i], 0.0);
+    }
+
+    FFTPlan plan(N);
+    plan.forward(out);
+    // Keep DC (and Nyquist for even N), double the positive bins, clear the negative ones
+    const size_t half = (N + 1) / 2;
+    for(size_t f = 1; f < half; f++)
+    {
+        out[f].re *= 2.0;
+        out[f].im *= 2.0;
+    }
+    for(size_t f = N / 2 + 1; f < N; f++)
+    {
+        out[f] = complex_t();
+    }
+    plan.inverse(out);
+
+    // The real part is sig up to rounding, so restore it exactly
+    for(size_t i = 0; i < N; i++)
+    {
+        out[i].re = sig[i];
+    }
+}
+
+std::vector<complex_t> calcAnalyticSignal
+(
+    const std::vector<double>& sig
+)
+{
+    std::vector<complex_t> x(sig.size());
+    calcAnalyticSignal(sig.data(), sig.size(), x.data());
+    return x;
+}
+
+std::vector<double> calcEnvelope
+(
+    const std::vector<double>& sig
+)
+{
+    std::vector<complex_t> a = calcAnalyticSignal(sig);
+    std::vector<double> env(a.size());
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        env[i] = std::sqrt(a[i].re * a[i].re + a[i].im * a[i].im);
+    }
+    return env;
+}
+
+void calcAnalyticFeatures
+(
+    const complex_t* analytic,
+    const size_t n,
+    double* magnitude,
+    double* phase,
+    double* frequency,
+    const double sampleRate,
+    const bool fast
+)
+{
+    if(n == 0)
+    {
+        return;
+    }
+    // Outputs the caller does not want go to scratch, so the loop stays branch-free
+    std::vector<double> scratch;
+    if(magnitude == NULL || phase == NULL || frequency == NULL)
+    {
+        scratch.resize(n);
+    }
+    // Using a[0] as its own predecessor gives a zero first step
+    featuresInto(analytic, n, analytic[0], sampleRate, fast,
+                 magnitude != NULL ? magnitude : scratch.data(),
+                 phase != NULL ? phase : scratch.data(),
+                 frequency != NULL ? frequency : scratch.data());
+}
+
+AnalyticFeatures calcAnalyticFeatures
+(
+    const std::vector<complex_t>& analytic,
+    const double sampleRate,
+    const bool fast
+)
+{
+    const size_t N = analytic.size();
+    AnalyticFeatures out;
+    out.magnitude.resize(N);
+    out.phase.resize(N);
+    out.frequency.resize(N);
+    calcAnalyticFeatures(analytic.data(), N, out.magnitude.data(), out.phase.data(),
+                         out.frequency.data(), sampleRate, fast);
+    return out;
+}
+
+std::vector<double> designHilbertFIR
+(
+    const size_t numTaps,
+    const WindowType type
+)
+{
+    const size_t L = numTaps | 1;
+    const size_t M = L / 2;
+    std::vector<double> h = makeWindow(type, L, false);
+    for(size_t k = 0; k < L; k++)
+    {
+        long m = (long)k - (long)M;
+        h[k] = (m % 2 != 0) ? h[k] * 2.0 / (M_PI * (double)m) : 0.0;
+    }
+    return h;
+}
+
+HilbertFIR::HilbertFIR(size_t numTaps, WindowType type)
+    : len(numTaps | 1),
+      mid(len / 2)
+{
+    std::vector<double> h = designHilbertFIR(len, type);
+    for(size_t m = 1; m <= mid; m += 2)
+    {
+        oddTaps.push_back(h[mid + m]);
+    }
+    reset();
+}
+
+void HilbertFIR::reset()
+{
+    history.assign(2 * len, 0.0);
+    pos = 0;
+    last = complex_t();
+}
+
+std::vector<complex_t> HilbertFIR::process(const std::vector<double>& in)
+{
+    const size_t T = oddTaps.size();
+    std::vector<complex_t> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        history[pos] = in[i];
+        history[pos + len] = in[i];
+        pos = (pos + 1 == len) ? 0 : pos + 1;
+
+        // Window oldest to newest, its centre is the sample delay() ago. The taps are
+        // antisymmetric, so fold the pair around the centre before multiplying.
+        const double* w = history.data() + pos + mid;
+        double acc = 0.0;
+        for(size_t t = 0; t < T; t++)
+        {
+            const size_t m = 2 * t + 1;
+            acc += oddTaps[t] * (w[-(long)m] - w[m]);
+        }
+        out[i] = complex_t(w[0], acc);
+    }
+    return out;
+}
+
+AnalyticFeatures HilbertFIR::processFeatures(const std::vector<double>& in, double sampleRate, bool fast)
+{
+    std::vector<complex_t> a = process(in);
+    AnalyticFeatures out;
+    out.magnitude.resize(a.size());
+    out.phase.resize(a.size());
+    out.frequency.resize(a.size());
+    featuresInto(a.data(), a.size(), last, sampleRate, fast,
+                 out.magnitude.data(), out.phase.data(), out.frequency.data());
+    if(!a.empty())
+    {
+        last = a.back();
+    }
+    return out;
+}
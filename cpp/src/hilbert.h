@@ -0,0 +1,232 @@
+/*************  ✨ Hilbert Transform 🌟  *************/
+/**
+ * \file hilbert.h
+ * \brief Analytic signals, envelopes, instantaneous phase and instantaneous frequency
+ */
+
+#ifndef HILBERT_H
+#define HILBERT_H
+
+#include "libdsp.h"
+#include "window.h"
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief Fast approximate atan2
+ *
+ * Folds the angle into the first octant and evaluates a degree 11 odd minimax polynomial
+ * for atan on [0, 1]. The absolute error is below 2e-6 rad over the whole plane, and the
+ * only branches are selects that compile to blends.
+ *
+ * @param y Imaginary (sine) component
+ * @param x Real (cosine) component
+ *
+ * @return The angle of (x, y) in radians, in [-pi, pi]. 0 for the origin.
+ */
+inline double fastAtan2
+(
+    const double y,
+    const double x
+)
+{
+    const double ax = std::fabs(x);
+    const double ay = std::fabs(y);
+    const double hi = ax > ay ? ax : ay;
+    const double lo = ax > ay ? ay : ax;
+    const double z = hi > 0.0 ? lo / hi : 0.0;
+    const double z2 = z * z;
+    double a = z * (0.99997726 + z2 * (-0.33262347 + z2 * (0.19354346 + z2 * (-0.11643287 + z2 * (0.05265332 + z2 * -0.01172120)))));
+    a = ay > ax ? 0.5 * M_PI - a : a;
+    a = x < 0.0 ? M_PI - a : a;
+    return y < 0.0 ? -a : a;
+}
+
+/**
+ * \brief Magnitude, phase and instantaneous frequency of an analytic signal
+ */
+struct AnalyticFeatures
+{
+    /**
+     * \brief Envelope |a[n]|
+     */
+    std::vector<double> magnitude;
+
+    /**
+     * \brief Instantaneous phase angle(a[n]) in radians, wrapped to [-pi, pi]
+     */
+    std::vector<double> phase;
+
+    /**
+     * \brief Instantaneous frequency, from the phase step angle(a[n] * conj(a[n-1]))
+     */
+    std::vector<double> frequency;
+};
+
+/**
+ * \brief Compute the analytic signal of a real signal into a caller owned buffer
+ *
+ * The FFT runs in out itself, so nothing is allocated besides the plan.
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param out n complex samples, must not overlap sig
+ *
+ * @returns void
+ */
+void calcAnalyticSignal
+(
+    const double* sig,
+    const size_t n,
+    complex_t* out
+);
+
+/**
+ * \brief Compute the analytic signal of a real signal with an FFT
+ *
+ * Zeroes the negative frequencies and doubles the positive ones, like MATLAB's hilbert().
+ * Works for any length.
+ *
+ * @param sig Real signal
+ *
+ * @return The analytic signal, its real part is sig and its imaginary part the Hilbert transform
+ */
+std::vector<complex_t> calcAnalyticSignal
+(
+    const std::vector<double>& sig
+);
+
+/**
+ * \brief Compute the envelope of a real signal
+ *
+ * @param sig Real signal
+ *
+ * @return The magnitude of the analytic signal
+ */
+std::vector<double> calcEnvelope
+(
+    const std::vector<double>& sig
+);
+
+/**
+ * \brief Compute envelope, phase and instantaneous frequency into caller owned buffers
+ *
+ * @param analytic n complex samples
+ * @param n Signal length
+ * @param magnitude n samples, may be NULL
+ * @param phase n samples, may be NULL
+ * @param frequency n samples, may be NULL. The first value is 0.
+ * @param sampleRate Sample rate, the frequency output is in the same units
+ * @param fast Use fastAtan2 instead of std::atan2
+ *
+ * @returns void
+ */
+void calcAnalyticFeatures
+(
+    const complex_t* analytic,
+    const size_t n,
+    double* magnitude,
+    double* phase,
+    double* frequency,
+    const double sampleRate = 1.0,
+    const bool fast = true
+);
+
+/**
+ * \brief Compute envelope, phase and instantaneous frequency in one pass
+ *
+ * @param analytic Analytic signal
+ * @param sampleRate Sample rate, the frequency output is in the same units
+ * @param fast Use fastAtan2 instead of std::atan2
+ *
+ * @return The three feature vectors. The first frequency value is 0, as it has no
+ *         previous sample.
+ */
+AnalyticFeatures calcAnalyticFeatures
+(
+    const std::vector<complex_t>& analytic,
+    const double sampleRate = 1.0,
+    const bool fast = true
+);
+
+/**
+ * \brief Design a type III FIR Hilbert transformer
+ *
+ * @param numTaps Number of taps, rounded up to an odd number
+ * @param type Window applied to the ideal response 2 / (pi * n)
+ *
+ * @return The filter taps. Every other tap, including the centre, is zero.
+ */
+std::vector<double> designHilbertFIR
+(
+    const size_t numTaps,
+    const WindowType type = WINDOW_BLACKMAN
+);
+
+/**
+ * \brief Streaming FIR Hilbert transformer
+ *
+ * Produces the analytic signal block by block. The real part is the input delayed by the
+ * filter's group delay, (numTaps - 1) / 2 samples, so both parts line up. The filter is
+ * antisymmetric with zero even taps, so each output costs numTaps / 4 multiplies.
+ */
+class HilbertFIR
+{
+public:
+    /**
+     * \brief Constructor for HilbertFIR
+     *
+     * @param numTaps Number of taps, rounded up to an odd number. More taps extend the
+     *                passband towards 0 Hz and fs / 2.
+     * @param type Window applied to the ideal response
+     */
+    explicit HilbertFIR(size_t numTaps = 63, WindowType type = WINDOW_BLACKMAN);
+
+    /**
+     * \brief Transform a block of samples
+     *
+     * @param in Input block
+     *
+     * @return The analytic signal, delayed by delay() samples
+     */
+    std::vector<complex_t> process(const std::vector<double>& in);
+
+    /**
+     * \brief Transform a block of samples straight to envelope, phase and frequency
+     *
+     * The frequency of the first sample of a block uses the last sample of the previous
+     * block, so the output is continuous across blocks.
+     *
+     * @param in Input block
+     * @param sampleRate Sample rate
+     * @param fast Use fastAtan2 instead of std::atan2
+     *
+     * @return The features of the delayed analytic signal
+     */
+    AnalyticFeatures processFeatures(const std::vector<double>& in, double sampleRate = 1.0, bool fast = true);
+
+    /**
+     * \brief Access the group delay
+     *
+     * @returns The delay of the output in samples
+     */
+    size_t delay() const { return mid; };
+
+    /**
+     * \brief Clear the filter history
+     *
+     * @returns void
+     */
+    void reset();
+
+private:
+    // Odd tap values g[i] = h[mid + 2i + 1]
+    std::vector<double> oddTaps;
+    size_t len;
+    size_t mid;
+    std::vector<double> history;
+    size_t pos;
+    complex_t last;
+};
+
+#endif
@@ -5,8 +5,17 @@ std::vector<complex_t> calcSigDFT_f(
     const size_t N
 )
 {
-    // Initialize the DFT
     std::vector<complex_t> dft(N, {0.0, 0.0});
+    if(hasFftCodelet(N))
+    {
+        // Fold the signal onto N samples (the DFT kernel has period N) and use a fixed size FFT
+        for(size_t s = 0; s < signal.size(); ++s)
+        {
+            dft[s % N].re += signal[s];
+        }
+        fftCodelet(dft.data(), N);
+        return dft;
+    }
 
     // Iterate through each frequency bin
     for(size_t f = 0; f < N; ++f)
@@ -31,6 +40,22 @@ std::vector<double> calcSigIDFT_f(
 {
     std::vector<double> idft(N, 0.0);
 
+    // Re(sum X e^(+j theta)) == Re(sum conj(X) e^(-j theta)), so a forward FFT codelet applies
+    if(dft.size() >= N && hasFftCodelet(N))
+    {
+        std::vector<complex_t> buf(N);
+        for(size_t s = 0; s < N; ++s)
+        {
+            buf[s] = complex_t(dft[s].re, -dft[s].im);
+        }
+        fftCodelet(buf.data(), N);
+        for(size_t f = 0; f < N; ++f)
+        {
+            idft[f] = buf[f].re / (double)N;
+        }
+        return idft;
+    }
+
     for(size_t f = 0; f < N; ++f)
     {
         idft[f] = 0.0;
@@ -50,7 +75,22 @@ std::vector<complex_t> calcSigDFT
     const std::vector<complex_t>& signal
 )
 {
+    // sum x e^(+j theta) == conj(sum conj(x) e^(-j theta)), so a forward FFT codelet applies
     std::vector<complex_t> dft(signal.size(), {0.0, 0.0});
+    if(hasFftCodelet(dft.size()))
+    {
+        for(size_t s = 0; s < signal.size(); ++s)
+        {
+            dft[s] = complex_t(signal[s].re, -signal[s].im);
+        }
+        fftCodelet(dft.data(), dft.size());
+        for(size_t f = 0; f < dft.size(); ++f)
+        {
+            dft[f].im = -dft[f].im;
+        }
+        return dft;
+    }
+
     for(size_t f = 0; f < signal.size(); ++f)
     {
         complex_t sum = {0.0, 0.0};
@@ -10,6 +10,7 @@
 #define USE_MATH_DEFINES
 
 #include "complextype.h"
+#include "codelets.h"
 #include <stdint.h>
 #include <vector>
 #include <math.h>
@@ -93,6 +94,51 @@ double calcSigStd
     return std::sqrt(calcSigVar(sig));
 }
 
+/**
+ * \brief Do a full convolution of signal with kernel into a caller owned buffer
+ * 
+ * @param sig n samples
+ * @param n Signal length
+ * @param kernel k taps
+ * @param k Kernel length
+ * @param out n + k - 1 samples, must not overlap sig or kernel
+ *  
+ * @returns void
+ */
+template <typename T>
+void convolveFull
+(
+    const T* sig,
+    const size_t n,
+    const T* kernel,
+    const size_t k,
+    T* out
+)
+{
+    if(n == 0 || k == 0)
+    {
+        return;
+    }
+    // Use the unrolled kernel when the tap count is known at compile time
+    if(firCodelet(sig, n, kernel, k, out))
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < n + k - 1; i++)
+    {
+        out[i] = T();
+    }
+
+    for(size_t i = 0; i < n; i++)
+    {
+        for(size_t j = 0; j < k; j++)
+        {
+            out[i+j] += sig[i] * kernel[j];
+        }
+    }
+}
+
 /**
  * \brief Do a full convolution of signal with kernel
  * 
@@ -109,15 +155,7 @@ std::vector<T> convolveFull
 )
 {
     std::vector<T> convolvedSig(sig.size() + kernel.size() - 1);
-
-    for(size_t i = 0; i < sig.size(); i++)
-    {
-        for(size_t j = 0; j < kernel.size(); j++)
-        {
-            convolvedSig[i+j] += sig[i] * kernel[j];
-        }
-    }
-
+    convolveFull(sig.data(), sig.size(), kernel.data(), kernel.size(), convolvedSig.data());
     return convolvedSig;
 }
 
@@ -16,9 +16,13 @@ int main() {
     std::vector<double> convolvedSignal = convolveFull(waveform, impulseResponse);
 
     exportToFile_f(convolvedSignal, "convolved_signal.dat", dataPath);
+    exportToFile_pyramid(convolvedSignal, "convolved_signal.pyr", dataPath);
+    exportToFile_raw(convolvedSignal, "convolved_signal.f64", dataPath);
 
     std::vector<complexDSP::complex_t> dft = calcSigDFT_f(waveform, waveform.size());
 
+    exportToFile_raw(dft, "dft.c128", dataPath);
+
     std::vector<double> dft_real(dft.size(), 0.0);
     std::vector<double> dft_imag(dft.size(), 0.0);
 
@@ -0,0 +1,506 @@
+#include "movingstats.h"
+#include <algorithm>
+#include <cmath>
+
+MovingSum::MovingSum(size_t window)
+    : buf(window > 0 ? window : 1)
+{
+    reset();
+}
+
+void MovingSum::reset()
+{
+    std::fill(buf.begin(), buf.end(), 0.0);
+    idx = 0;
+    fill = 0;
+    total = 0.0;
+}
+
+double MovingSum::push(double x)
+{
+    // Slots that have not been written yet hold zero, so warm-up needs no special case
+    total += x - buf[idx];
+    buf[idx] = x;
+    if(fill < buf.size())
+    {
+        fill++;
+    }
+    if(++idx == buf.size())
+    {
+        // Re-anchor once per window to discard accumulated rounding error
+        idx = 0;
+        total = 0.0;
+        for(size_t i = 0; i < buf.size(); i++)
+        {
+            total += buf[i];
+        }
+    }
+    return total;
+}
+
+std::vector<double> MovingSum::process(const std::vector<double>& in)
+{
+    std::vector<double> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        out[i] = push(in[i]);
+    }
+    return out;
+}
+
+std::vector<double> MovingMean::process(const std::vector<double>& in)
+{
+    std::vector<double> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        out[i] = push(in[i]);
+    }
+    return out;
+}
+
+double MovingRMS::push(double x)
+{
+    double ms = acc.push(x * x) / (double)acc.count();
+    return ms > 0.0 ? std::sqrt(ms) : 0.0;
+}
+
+std::vector<double> MovingRMS::process(const std::vector<double>& in)
+{
+    std::vector<double> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        out[i] = push(in[i]);
+    }
+    return out;
+}
+
+MovingVariance::MovingVariance(size_t window)
+    : buf(window > 0 ? window : 1)
+{
+    reset();
+}
+
+void MovingVariance::reset()
+{
+    idx = 0;
+    fill = 0;
+    shift = 0.0;
+    s1 = 0.0;
+    s2 = 0.0;
+}
+
+void MovingVariance::reanchor()
+{
+    // Move the shift to the window mean and recompute both sums exactly
+    double sum = 0.0;
+    for(size_t i = 0; i < fill; i++)
+    {
+        sum += buf[i];
+    }
+    shift = sum / (double)fill;
+    s1 = 0.0;
+    s2 = 0.0;
+    for(size_t i = 0; i < fill; i++)
+    {
+        double y = buf[i] - shift;
+        s1 += y;
+        s2 += y * y;
+    }
+}
+
+double MovingVariance::push(double x)
+{
+    if(fill == 0)
+    {
+        shift = x;
+    }
+    double y = x - shift;
+    if(fill < buf.size())
+    {
+        fill++;
+    }
+    else
+    {
+        // Window full: remove the oldest sample
+        double z = buf[idx] - shift;
+        y -= z;
+        s2 -= z * z;
+    }
+    buf[idx] = x;
+    s1 += y;
+    s2 += (x - shift) * (x - shift);
+    if(++idx == buf.size())
+    {
+        idx = 0;
+        reanchor();
+    }
+    double n = (double)fill;
+    return fill > 1 ? std::max(s2 - s1 * s1 / n, 0.0) / (n - 1.0) : 0.0;
+}
+
+double MovingVariance::mean() const
+{
+    return fill > 0 ? shift + s1 / (double)fill : 0.0;
+}
+
+std::vector<double> MovingVariance::process(const std::vector<double>& in)
+{
+    std::vector<double> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        out[i] = push(in[i]);
+    }
+    return out;
+}
+
+MovingMax::MovingMax(size_t window)
+    : sign(1.0),
+      val(window > 0 ? window : 1),
+      pos(window > 0 ? window : 1)
+{
+    reset();
+}
+
+void MovingMax::reset()
+{
+    head = 0;
+    len = 0;
+    n = 0;
+}
+
+double MovingMax::push(double x)
+{
+    const size_t W = val.size();
+    double v = sign * x;
+
+    // Drop the front candidate once it has left the window
+    if(len > 0 && pos[head] + W <= n)
+    {
+        head = (head + 1 == W) ? 0 : head + 1;
+        len--;
+    }
+    // Drop candidates from the back that can never be the maximum again
+    while(len > 0)
+    {
+        size_t back = (head + len - 1) % W;
+        if(val[back] > v)
+        {
+            break;
+        }
+        len--;
+    }
+    size_t slot = (head + len) % W;
+    val[slot] = v;
+    pos[slot] = n;
+    len++;
+    n++;
+
+    return sign * val[head];
+}
+
+std::vector<double> MovingMax::process(const std::vector<double>& in)
+{
+    std::vector<double> out(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        out[i] = push(in[i]);
+    }
+    return out;
+}
+
+namespace
+{
+
+// Moving sum of x into out using block-wise re-anchored prefix sums.
+// Within each block of W outputs the work is a difference x[i] - x[i-W], which
+// vectorizes under the Makefile's cheap cost model, followed by one scan seeded
+// with an exactly computed sum.
+void movingSum(const double* x, size_t N, size_t W, double* out)
+{
+    for(size_t s = 0; s < N; s += W)
+    {
+        size_t e = std::min(s + W, N);
+        double acc = 0.0;
+        for(size_t j = (s > W ? s - W : 0); j < s; j++)
+        {
+            acc += x[j];
+        }
+        if(s == 0)
+        {
+            for(size_t i = s; i < e; i++)
+            {
+                out[i] = x[i];
+            }
+        }
+        else
+        {
+            for(size_t i = s; i < e; i++)
+            {
+                out[i] = x[i] - x[i - W];
+            }
+        }
+        for(size_t i = s; i < e; i++)
+        {
+            acc += out[i];
+            out[i] = acc;
+        }
+    }
+}
+
+struct MaxOp
+{
+    double operator()(double a, double b) const { return a > b ? a : b; }
+};
+
+struct MinOp
+{
+    double operator()(double a, double b) const { return a < b ? a : b; }
+};
+
+// van Herk / Gil-Werman: prefix and suffix extrema within blocks of W,
+// combined with one branch-free pass. Three comparisons per sample. The prefix
+// extrema are built in out, each output only reads its own prefix.
+template <typename Op>
+void movingExtreme(const double* sig, size_t N, size_t W, Op op, double* out)
+{
+    if(N == 0)
+    {
+        return;
+    }
+    W = std::max<size_t>(W, 1);
+
+    double* pre = out;
+    std::vector<double> suf(N);
+    for(size_t s = 0; s < N; s += W)
+    {
+        size_t e = std::min(s + W, N);
+        pre[s] = sig[s];
+        for(size_t i = s + 1; i < e; i++)
+        {
+            pre[i] = op(pre[i - 1], sig[i]);
+        }
+        suf[e - 1] = sig[e - 1];
+        for(size_t i = e - 1; i > s; i--)
+        {
+            suf[i - 1] = op(suf[i], sig[i - 1]);
+        }
+    }
+
+    // Partial windows at the start are plain prefix extrema of the first block, already in out
+    for(size_t i = std::min(W - 1, N); i < N; i++)
+    {
+        out[i] = op(suf[i + 1 - W], pre[i]);
+    }
+}
+
+} // namespace
+
+void calcMovingSum
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    movingSum(sig, n, std::max<size_t>(window, 1), out);
+}
+
+std::vector<double> calcMovingSum
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingSum(sig.data(), sig.size(), window, out.data());
+    return out;
+}
+
+void calcMovingMean
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    const size_t W = std::max<size_t>(window, 1);
+    movingSum(sig, n, W, out);
+    for(size_t i = 0; i < n; i++)
+    {
+        out[i] /= (double)std::min(i + 1, W);
+    }
+}
+
+std::vector<double> calcMovingMean
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingMean(sig.data(), sig.size(), window, out.data());
+    return out;
+}
+
+void calcMovingRMS
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    const size_t W = std::max<size_t>(window, 1);
+    // movingSum reads samples a window back, so the squares cannot live in out
+    std::vector<double> sq(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        sq[i] = sig[i] * sig[i];
+    }
+    movingSum(sq.data(), n, W, out);
+    for(size_t i = 0; i < n; i++)
+    {
+        double ms = out[i] / (double)std::min(i + 1, W);
+        out[i] = ms > 0.0 ? std::sqrt(ms) : 0.0;
+    }
+}
+
+std::vector<double> calcMovingRMS
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingRMS(sig.data(), sig.size(), window, out.data());
+    return out;
+}
+
+void calcMovingVar
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    const size_t N = n;
+    const size_t W = std::max<size_t>(window, 1);
+    if(W == 1)
+    {
+        // A single sample window has variance 0
+        std::fill(out, out + N, 0.0);
+        return;
+    }
+    std::vector<double> s1(std::min(W, N));
+    std::vector<double> s2(std::min(W, N));
+
+    for(size_t s = 0; s < N; s += W)
+    {
+        size_t e = std::min(s + W, N);
+        size_t a = s > W ? s - W : 0;
+
+        // Shift by the mean of the anchor window so the sum of squares stays well conditioned
+        double c = sig[a];
+        if(s > 0)
+        {
+            c = 0.0;
+            for(size_t j = a; j < s; j++)
+            {
+                c += sig[j];
+            }
+            c /= (double)(s - a);
+        }
+        double acc1 = 0.0;
+        double acc2 = 0.0;
+        for(size_t j = a; j < s; j++)
+        {
+            acc1 += sig[j] - c;
+            acc2 += (sig[j] - c) * (sig[j] - c);
+        }
+
+        if(s == 0)
+        {
+            for(size_t i = s; i < e; i++)
+            {
+                double y = sig[i] - c;
+                s1[i - s] = y;
+                s2[i - s] = y * y;
+            }
+        }
+        else
+        {
+            for(size_t i = s; i < e; i++)
+            {
+                double y = sig[i] - c;
+                double z = sig[i - W] - c;
+                s1[i - s] = y - z;
+                s2[i - s] = y * y - z * z;
+            }
+        }
+        for(size_t i = s; i < e; i++)
+        {
+            acc1 += s1[i - s];
+            acc2 += s2[i - s];
+            double w = (double)std::min(i + 1, W);
+            out[i] = w > 1.0 ? std::max(acc2 - acc1 * acc1 / w, 0.0) / (w - 1.0) : 0.0;
+        }
+    }
+}
+
+std::vector<double> calcMovingVar
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingVar(sig.data(), sig.size(), window, out.data());
+    return out;
+}
+
+void calcMovingMax
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    movingExtreme(sig, n, window, MaxOp(), out);
+}
+
+std::vector<double> calcMovingMax
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingMax(sig.data(), sig.size(), window, out.data());
+    return out;
+}
+
+void calcMovingMin
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+)
+{
+    movingExtreme(sig, n, window, MinOp(), out);
+}
+
+std::vector<double> calcMovingMin
+(
+    const std::vector<double>& sig,
+    const size_t window
+)
+{
+    std::vector<double> out(sig.size());
+    calcMovingMin(sig.data(), sig.size(), window, out.data());
+    return out;
+}
@@ -0,0 +1,487 @@
+/*************  ✨ Moving Window Statistics 🌟  *************/
+/**
+ * \file movingstats.h
+ * \brief Streaming and batch sliding-window sum, mean, RMS, variance, min and max
+ *
+ * Every operator costs O(1) per sample regardless of the window length. Outputs for the
+ * first window - 1 samples are computed over the samples seen so far, so all outputs
+ * line up one to one with the inputs.
+ *
+ * Sums are updated incrementally and re-anchored (recomputed exactly from the window
+ * contents) once per window length, which bounds floating point drift without changing
+ * the amortized cost.
+ */
+
+#ifndef MOVINGSTATS_H
+#define MOVINGSTATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief Streaming moving sum
+ */
+class MovingSum
+{
+public:
+    /**
+     * \brief Constructor for MovingSum
+     *
+     * @param window Window length in samples, must be at least 1
+     */
+    explicit MovingSum(size_t window);
+
+    /**
+     * \brief Add a sample to the window
+     *
+     * @param x The new sample
+     *
+     * @returns The sum of the current window
+     */
+    double push(double x);
+
+    /**
+     * \brief Run a block of samples through the window
+     *
+     * @param in Input block
+     *
+     * @return The window sum after each input sample
+     */
+    std::vector<double> process(const std::vector<double>& in);
+
+    /**
+     * \brief Access the sum of the current window
+     *
+     * @returns The window sum
+     */
+    double sum() const { return total; };
+
+    /**
+     * \brief Access the number of samples in the window
+     *
+     * @returns The number of samples currently in the window, at most the window length
+     */
+    size_t count() const { return fill; };
+
+    /**
+     * \brief Empty the window
+     *
+     * @returns void
+     */
+    void reset();
+
+private:
+    std::vector<double> buf;
+    size_t idx;
+    size_t fill;
+    double total;
+};
+
+/**
+ * \brief Streaming moving mean
+ */
+class MovingMean
+{
+public:
+    /**
+     * \brief Constructor for MovingMean
+     *
+     * @param window Window length in samples, must be at least 1
+     */
+    explicit MovingMean(size_t window) : acc(window) {};
+
+    /**
+     * \brief Add a sample to the window
+     *
+     * @param x The new sample
+     *
+     * @returns The mean of the current window
+     */
+    double push(double x) { return acc.push(x) / (double)acc.count(); };
+
+    /**
+     * \brief Run a block of samples through the window
+     *
+     * @param in Input block
+     *
+     * @return The window mean after each input sample
+     */
+    std::vector<double> process(const std::vector<double>& in);
+
+    /**
+     * \brief Empty the window
+     *
+     * @returns void
+     */
+    void reset() { acc.reset(); };
+
+private:
+    MovingSum acc;
+};
+
+/**
+ * \brief Streaming moving root mean square
+ */
+class MovingRMS
+{
+public:
+    /**
+     * \brief Constructor for MovingRMS
+     *
+     * @param window Window length in samples, must be at least 1
+     */
+    explicit MovingRMS(size_t window) : acc(window) {};
+
+    /**
+     * \brief Add a sample to the window
+     *
+     * @param x The new sample
+     *
+     * @returns The RMS of the current window
+     */
+    double push(double x);
+
+    /**
+     * \brief Run a block of samples through the window
+     *
+     * @param in Input block
+     *
+     * @return The window RMS after each input sample
+     */
+    std::vector<double> process(const std::vector<double>& in);
+
+    /**
+     * \brief Empty the window
+     *
+     * @returns void
+     */
+    void reset() { acc.reset(); };
+
+private:
+    MovingSum acc;
+};
+
+/**
+ * \brief Streaming moving variance
+ *
+ * Keeps the sum and sum of squares of the samples minus a shift, and moves the shift
+ * to the window mean at every re-anchor. This avoids the cancellation of the plain sum
+ * of squares formula when the mean is large compared to the spread. Like calcSigVar
+ * this is the sample variance (divides by count - 1); a single sample has variance 0.
+ */
+class MovingVariance
+{
+public:
+    /**
+     * \brief Constructor for MovingVariance
+     *
+     * @param window Window length in samples, must be at least 1. A window of 1 always
+     *               has variance 0.
+     */
+    explicit MovingVariance(size_t window);
+
+    /**
+     * \brief Add a sample to the window
+     *
+     * @param x The new sample
+     *
+     * @returns The variance of the current window
+     */
+    double push(double x);
+
+    /**
+     * \brief Run a block of samples through the window
+     *
+     * @param in Input block
+     *
+     * @return The window variance after each input sample
+     */
+    std::vector<double> process(const std::vector<double>& in);
+
+    /**
+     * \brief Access the mean of the current window
+     *
+     * @returns The window mean
+     */
+    double mean() const;
+
+    /**
+     * \brief Empty the window
+     *
+     * @returns void
+     */
+    void reset();
+
+private:
+    void reanchor();
+
+    std::vector<double> buf;
+    size_t idx;
+    size_t fill;
+    double shift;
+    double s1;
+    double s2;
+};
+
+/**
+ * \brief Streaming moving maximum
+ *
+ * Keeps a monotonic deque of candidate maxima in a fixed ring of window length, so
+ * each sample is pushed and popped at most once and nothing is allocated after
+ * construction.
+ */
+class MovingMax
+{
+public:
+    /**
+     * \brief Constructor for MovingMax
+     *
+     * @param window Window length in samples, must be at least 1
+     */
+    explicit MovingMax(size_t window);
+
+    /**
+     * \brief Add a sample to the window
+     *
+     * @param x The new sample
+     *
+     * @returns The maximum of the current window
+     */
+    double push(double x);
+
+    /**
+     * \brief Run a block of samples through the window
+     *
+     * @param in Input block
+     *
+     * @return The window maximum after each input sample
+     */
+    std::vector<double> process(const std::vector<double>& in);
+
+    /**
+     * \brief Empty the window
+     *
+     * @returns void
+     */
+    void reset();
+
+protected:
+    // Sign applied to samples, so MovingMin can reuse the max deque
+    double sign;
+
+private:
+    std::vector<double> val;
+    std::vector<uint64_t> pos;
+    size_t head;
+    size_t len;
+    uint64_t n;
+};
+
+/**
+ * \brief Streaming moving minimum
+ */
+class MovingMin : public MovingMax
+{
+public:
+    /**
+     * \brief Constructor for MovingMin
+     *
+     * @param window Window length in samples, must be at least 1
+     */
+    explicit MovingMin(size_t window) : MovingMax(window) { sign = -1.0; };
+};
+
+/**
+ * \brief Compute the moving sum of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples
+ * @param out n samples, the sum of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingSum
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving sum of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples
+ *
+ * @return The sum of the window ending at each sample
+ */
+std::vector<double> calcMovingSum
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+/**
+ * \brief Compute the moving mean of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples
+ * @param out n samples, the mean of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingMean
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving mean of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples
+ *
+ * @return The mean of the window ending at each sample
+ */
+std::vector<double> calcMovingMean
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+/**
+ * \brief Compute the moving RMS of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples
+ * @param out n samples, the RMS of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingRMS
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving RMS of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples
+ *
+ * @return The RMS of the window ending at each sample
+ */
+std::vector<double> calcMovingRMS
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+/**
+ * \brief Compute the moving sample variance of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples, all outputs are 0 for a window of 1
+ * @param out n samples, the variance of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingVar
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving sample variance of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples, all outputs are 0 for a window of 1
+ *
+ * @return The variance of the window ending at each sample
+ */
+std::vector<double> calcMovingVar
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+/**
+ * \brief Compute the moving maximum of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples
+ * @param out n samples, the maximum of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingMax
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving maximum of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples
+ *
+ * @return The maximum of the window ending at each sample
+ */
+std::vector<double> calcMovingMax
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+/**
+ * \brief Compute the moving minimum of a signal into a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window length in samples
+ * @param out n samples, the minimum of the window ending at each sample. Must not overlap sig.
+ *
+ * @returns void
+ */
+void calcMovingMin
+(
+    const double* sig,
+    const size_t n,
+    const size_t window,
+    double* out
+);
+
+/**
+ * \brief Compute the moving minimum of a signal
+ *
+ * @param sig Signal
+ * @param window Window length in samples
+ *
+ * @return The minimum of the window ending at each sample
+ */
+std::vector<double> calcMovingMin
+(
+    const std::vector<double>& sig,
+    const size_t window
+);
+
+#endif
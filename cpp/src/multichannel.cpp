@@ -0,0 +1,100 @@
+#include "multichannel.h"
+
+InterleavedSignal<complex_t> calcChannelDFT
+(
+    const InterleavedSignal<double>& sig
+)
+{
+    const size_t C = sig.channels();
+    const size_t N = sig.frames();
+    InterleavedSignal<complex_t> out(C, N);
+
+    if(N == 0 || (N & (N - 1)) != 0)
+    {
+        // No radix-2 path for this size, transform each channel on its own
+        for(size_t c = 0; c < C; c++)
+        {
+            std::vector<complex_t> dft = calcSigDFT_f(sig.channel(c).toVector(), N);
+            ChannelView<complex_t> dst = out.channel(c);
+            for(size_t f = 0; f < N; f++)
+            {
+                dst[f] = dft[f];
+            }
+        }
+        return out;
+    }
+
+    // Load the frames in bit-reversed order
+    size_t bits = 0;
+    while(((size_t)1 << bits) < N)
+    {
+        bits++;
+    }
+    for(size_t n = 0; n < N; n++)
+    {
+        size_t r = 0;
+        for(size_t b = 0; b < bits; b++)
+        {
+            r |= ((n >> b) & 1) << (bits - 1 - b);
+        }
+        const double* x = sig.data() + n * C;
+        complex_t* y = out.data() + r * C;
+        for(size_t c = 0; c < C; c++)
+        {
+            y[c].re = x[c];
+        }
+    }
+
+    // Twiddles e^(-j*2*pi*k/N), computed once and strided through by each stage
+    std::vector<complex_t> w(N / 2);
+    for(size_t k = 0; k < N / 2; k++)
+    {
+        double theta = 2.0 * M_PI * (double)k / (double)N;
+        w[k] = complex_t(std::cos(theta), -std::sin(theta));
+    }
+
+    // Radix-2 butterflies, each applied to a whole frame of channels
+    complex_t* d = out.data();
+    for(size_t len = 2; len <= N; len <<= 1)
+    {
+        const size_t half = len / 2;
+        const size_t step = N / len;
+        for(size_t start = 0; start < N; start += len)
+        {
+            for(size_t k = 0; k < half; k++)
+            {
+                const double wr = w[k * step].re;
+                const double wi = w[k * step].im;
+                complex_t* a = d + (start + k) * C;
+                complex_t* b = d + (start + k + half) * C;
+                for(size_t c = 0; c < C; c++)
+                {
+                    double tr = wr * b[c].re - wi * b[c].im;
+                    double ti = wr * b[c].im + wi * b[c].re;
+                    b[c].re = a[c].re - tr;
+                    b[c].im = a[c].im - ti;
+                    a[c].re += tr;
+                    a[c].im += ti;
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
+InterleavedSignal<double> calcChannelDFTMag
+(
+    const InterleavedSignal<complex_t>& dft
+)
+{
+    InterleavedSignal<double> mag(dft.channels(), dft.frames());
+    const size_t total = dft.channels() * dft.frames();
+    const complex_t* x = dft.data();
+    double* y = mag.data();
+    for(size_t i = 0; i < total; i++)
+    {
+        y[i] = std::sqrt(x[i].re * x[i].re + x[i].im * x[i].im);
+    }
+    return mag;
+}
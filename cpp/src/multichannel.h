@@ -0,0 +1,445 @@
+/*************  ✨ Multi-Channel Signals 🌟  *************/
+/**
+ * \file multichannel.h
+ * \brief Interleaved and planar multi-channel containers and channel-batched operations
+ *
+ * Interleaved signals store one frame (a sample from every channel) after another, the
+ * way most multi-channel front ends deliver data. The batched operations below walk the
+ * frames once and keep the channel loop innermost, so the same operation is applied to
+ * adjacent memory for every channel and the compiler can vectorize across channels.
+ */
+
+#ifndef MULTICHANNEL_H
+#define MULTICHANNEL_H
+
+#include "libdsp.h"
+#include <stddef.h>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Stride-aware view of one channel of a multi-channel signal
+ *
+ * Does not own its data. The view is invalidated if the signal it was taken from is
+ * resized or destroyed.
+ */
+template <typename T>
+class ChannelView
+{
+public:
+    /**
+     * \brief Constructor for ChannelView
+     *
+     * @param data Pointer to the first sample of the channel
+     * @param len Number of samples in the channel
+     * @param stride Distance between consecutive samples, in elements
+     */
+    ChannelView(T* data, size_t len, size_t stride) : ptr{data}, len{len}, step{stride} {};
+
+    /**
+     * \brief Access a sample of the channel
+     *
+     * @param i Sample index
+     *
+     * @returns A reference to the sample
+     */
+    T& operator[](size_t i) const { return ptr[i * step]; };
+
+    /**
+     * \brief Access the number of samples in the channel
+     *
+     * @returns The channel length
+     */
+    size_t size() const { return len; };
+
+    /**
+     * \brief Access the distance between consecutive samples
+     *
+     * @returns The stride in elements
+     */
+    size_t stride() const { return step; };
+
+    /**
+     * \brief Copy the channel into a contiguous vector for use with the single channel API
+     *
+     * @returns The channel samples
+     */
+    std::vector<typename std::remove_const<T>::type> toVector() const
+    {
+        std::vector<typename std::remove_const<T>::type> out(len);
+        for(size_t i = 0; i < len; i++)
+        {
+            out[i] = ptr[i * step];
+        }
+        return out;
+    };
+
+private:
+    T* ptr;
+    size_t len;
+    size_t step;
+};
+
+/**
+ * \brief Multi-channel signal stored frame by frame: c0 c1 ... cN c0 c1 ... cN ...
+ */
+template <typename T>
+class InterleavedSignal
+{
+public:
+    /**
+     * \brief Default constructor for InterleavedSignal, creates an empty signal
+     */
+    InterleavedSignal() : numChannels{0}, numFrames{0} {};
+
+    /**
+     * \brief Constructor for InterleavedSignal, zero initialized
+     *
+     * @param channels Number of channels
+     * @param frames Number of samples per channel
+     */
+    InterleavedSignal(size_t channels, size_t frames)
+        : numChannels{channels}, numFrames{frames}, samples(channels * frames) {};
+
+    /**
+     * \brief Constructor for InterleavedSignal, taking ownership of interleaved samples
+     *
+     * @param channels Number of channels
+     * @param data Interleaved samples, trailing samples that do not fill a frame are dropped
+     */
+    InterleavedSignal(size_t channels, std::vector<T> data)
+        : numChannels{channels}, numFrames{channels ? data.size() / channels : 0}, samples(std::move(data))
+    {
+        samples.resize(numChannels * numFrames);
+    };
+
+    /**
+     * \brief Access a sample
+     *
+     * @param frame Frame index
+     * @param channel Channel index
+     *
+     * @returns A reference to the sample
+     */
+    T& at(size_t frame, size_t channel) { return samples[frame * numChannels + channel]; };
+    const T& at(size_t frame, size_t channel) const { return samples[frame * numChannels + channel]; };
+
+    /**
+     * \brief Access one channel as a strided view
+     *
+     * @param channel Channel index
+     *
+     * @returns A view of the channel
+     */
+    ChannelView<T> channel(size_t channel) { return ChannelView<T>(samples.data() + channel, numFrames, numChannels); };
+    ChannelView<const T> channel(size_t channel) const { return ChannelView<const T>(samples.data() + channel, numFrames, numChannels); };
+
+    /**
+     * \brief Access the number of channels
+     *
+     * @returns The channel count
+     */
+    size_t channels() const { return numChannels; };
+
+    /**
+     * \brief Access the number of samples per channel
+     *
+     * @returns The frame count
+     */
+    size_t frames() const { return numFrames; };
+
+    /**
+     * \brief Access the underlying interleaved samples
+     *
+     * @returns A pointer to the first sample of the first frame
+     */
+    T* data() { return samples.data(); };
+    const T* data() const { return samples.data(); };
+
+private:
+    size_t numChannels;
+    size_t numFrames;
+    std::vector<T> samples;
+};
+
+/**
+ * \brief Multi-channel signal stored channel by channel, each channel contiguous
+ */
+template <typename T>
+class PlanarSignal
+{
+public:
+    /**
+     * \brief Default constructor for PlanarSignal, creates an empty signal
+     */
+    PlanarSignal() : numChannels{0}, numFrames{0} {};
+
+    /**
+     * \brief Constructor for PlanarSignal, zero initialized
+     *
+     * @param channels Number of channels
+     * @param frames Number of samples per channel
+     */
+    PlanarSignal(size_t channels, size_t frames)
+        : numChannels{channels}, numFrames{frames}, samples(channels * frames) {};
+
+    /**
+     * \brief Access a sample
+     *
+     * @param frame Frame index
+     * @param channel Channel index
+     *
+     * @returns A reference to the sample
+     */
+    T& at(size_t frame, size_t channel) { return samples[channel * numFrames + frame]; };
+    const T& at(size_t frame, size_t channel) const { return samples[channel * numFrames + frame]; };
+
+    /**
+     * \brief Access one channel as a contiguous view
+     *
+     * @param channel Channel index
+     *
+     * @returns A view of the channel
+     */
+    ChannelView<T> channel(size_t channel) { return ChannelView<T>(samples.data() + channel * numFrames, numFrames, 1); };
+    ChannelView<const T> channel(size_t channel) const { return ChannelView<const T>(samples.data() + channel * numFrames, numFrames, 1); };
+
+    /**
+     * \brief Access the number of channels
+     *
+     * @returns The channel count
+     */
+    size_t channels() const { return numChannels; };
+
+    /**
+     * \brief Access the number of samples per channel
+     *
+     * @returns The frame count
+     */
+    size_t frames() const { return numFrames; };
+
+    /**
+     * \brief Access the underlying planar samples
+     *
+     * @returns A pointer to the first sample of the first channel
+     */
+    T* data() { return samples.data(); };
+    const T* data() const { return samples.data(); };
+
+private:
+    size_t numChannels;
+    size_t numFrames;
+    std::vector<T> samples;
+};
+
+/**
+ * \brief Convert a planar signal to interleaved layout
+ *
+ * @param sig Planar signal
+ *
+ * @return The same samples, interleaved
+ */
+template <typename T>
+InterleavedSignal<T> interleave
+(
+    const PlanarSignal<T>& sig
+)
+{
+    const size_t C = sig.channels();
+    InterleavedSignal<T> out(C, sig.frames());
+    for(size_t c = 0; c < C; c++)
+    {
+        const T* src = sig.data() + c * sig.frames();
+        T* dst = out.data() + c;
+        for(size_t n = 0; n < sig.frames(); n++)
+        {
+            dst[n * C] = src[n];
+        }
+    }
+    return out;
+}
+
+/**
+ * \brief Convert an interleaved signal to planar layout
+ *
+ * @param sig Interleaved signal
+ *
+ * @return The same samples, one contiguous block per channel
+ */
+template <typename T>
+PlanarSignal<T> deinterleave
+(
+    const InterleavedSignal<T>& sig
+)
+{
+    const size_t C = sig.channels();
+    PlanarSignal<T> out(C, sig.frames());
+    for(size_t c = 0; c < C; c++)
+    {
+        const T* src = sig.data() + c;
+        T* dst = out.data() + c * sig.frames();
+        for(size_t n = 0; n < sig.frames(); n++)
+        {
+            dst[n] = src[n * C];
+        }
+    }
+    return out;
+}
+
+/**
+ * \brief Compute the mean of every channel in one pass
+ *
+ * @param sig Interleaved signal
+ *
+ * @return The mean of each channel
+ */
+template <typename T>
+std::vector<double> calcChannelMean
+(
+    const InterleavedSignal<T>& sig
+)
+{
+    const size_t C = sig.channels();
+    std::vector<double> sum(C, 0.0);
+    const T* x = sig.data();
+    for(size_t n = 0; n < sig.frames(); n++, x += C)
+    {
+        for(size_t c = 0; c < C; c++)
+        {
+            sum[c] += x[c];
+        }
+    }
+    for(size_t c = 0; c < C; c++)
+    {
+        sum[c] /= (double)sig.frames();
+    }
+    return sum;
+}
+
+/**
+ * \brief Compute the variance of every channel
+ *
+ * @param sig Interleaved signal
+ *
+ * @return The sample variance of each channel, as calcSigVar would compute it
+ */
+template <typename T>
+std::vector<double> calcChannelVar
+(
+    const InterleavedSignal<T>& sig
+)
+{
+    const size_t C = sig.channels();
+    std::vector<double> mean = calcChannelMean(sig);
+    std::vector<double> var(C, 0.0);
+    const T* x = sig.data();
+    for(size_t n = 0; n < sig.frames(); n++, x += C)
+    {
+        for(size_t c = 0; c < C; c++)
+        {
+            var[c] += (x[c] - mean[c]) * (x[c] - mean[c]);
+        }
+    }
+    for(size_t c = 0; c < C; c++)
+    {
+        var[c] /= (double)(sig.frames() - 1);
+    }
+    return var;
+}
+
+/**
+ * \brief Compute the standard deviation of every channel
+ *
+ * @param sig Interleaved signal
+ *
+ * @return The standard deviation of each channel
+ */
+template <typename T>
+std::vector<double> calcChannelStd
+(
+    const InterleavedSignal<T>& sig
+)
+{
+    std::vector<double> sd = calcChannelVar(sig);
+    for(size_t c = 0; c < sd.size(); c++)
+    {
+        sd[c] = std::sqrt(sd[c]);
+    }
+    return sd;
+}
+
+/**
+ * \brief Full convolution of every channel with the same kernel
+ *
+ * Equivalent to calling convolveFull on each channel, but the channel loop is innermost
+ * so each kernel tap is applied to a whole frame of adjacent samples at once.
+ *
+ * @param sig Interleaved signal
+ * @param kernel Kernel
+ *
+ * @return Interleaved convolved signal with sig.frames() + kernel.size() - 1 frames
+ */
+template <typename T>
+InterleavedSignal<T> convolveFull
+(
+    const InterleavedSignal<T>& sig,
+    const std::vector<T>& kernel
+)
+{
+    const size_t C = sig.channels();
+    if(sig.frames() == 0 || kernel.empty())
+    {
+        return InterleavedSignal<T>(C, 0);
+    }
+    InterleavedSignal<T> out(C, sig.frames() + kernel.size() - 1);
+    for(size_t n = 0; n < out.frames(); n++)
+    {
+        // Taps that overlap the signal for output frame n
+        size_t kLo = n >= sig.frames() ? n - sig.frames() + 1 : 0;
+        size_t kHi = std::min(n + 1, kernel.size());
+        T* y = out.data() + n * C;
+        for(size_t k = kLo; k < kHi; k++)
+        {
+            const T* x = sig.data() + (n - k) * C;
+            const T h = kernel[k];
+            for(size_t c = 0; c < C; c++)
+            {
+                y[c] += x[c] * h;
+            }
+        }
+    }
+    return out;
+}
+
+/**
+ * \brief DFT of every channel of a real signal
+ *
+ * Computes the same transform as calcSigDFT_f(channel, frames) for each channel. For a
+ * power of two frame count a radix-2 FFT runs over all channels at once, sharing each
+ * twiddle factor across a frame of channels; other sizes fall back to one transform per
+ * channel.
+ *
+ * @param sig Interleaved real signal
+ *
+ * @return Interleaved complex spectrum with the same number of frames
+ */
+InterleavedSignal<complex_t> calcChannelDFT
+(
+    const InterleavedSignal<double>& sig
+);
+
+/**
+ * \brief Magnitude of every bin of a multi-channel spectrum
+ *
+ * @param dft Interleaved complex spectrum
+ *
+ * @return Interleaved magnitudes
+ */
+InterleavedSignal<double> calcChannelDFTMag
+(
+    const InterleavedSignal<complex_t>& dft
+);
+
+#endif
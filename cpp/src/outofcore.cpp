@@ -0,0 +1,311 @@
+#include "outofcore.h"
+#include "fftplan.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+
+// Rows or columns moved per transpose tile, keeps both sides of the copy in L1
+const size_t OOC_TILE = 32;
+
+// A read-only or read-write mapping of a whole file
+struct MappedFile
+{
+    int fd = -1;
+    void* base = MAP_FAILED;
+    size_t bytes = 0;
+
+    bool openRead(const std::string& name)
+    {
+        fd = open(name.c_str(), O_RDONLY);
+        struct stat st;
+        if(fd < 0 || fstat(fd, &st) != 0)
+        {
+            return false;
+        }
+        bytes = (size_t)st.st_size;
+        if(bytes == 0)
+        {
+            return false;
+        }
+        base = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        return base != MAP_FAILED;
+    }
+
+    bool create(const std::string& name, size_t size)
+    {
+        fd = open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0 || ftruncate(fd, (off_t)size) != 0)
+        {
+            return false;
+        }
+        bytes = size;
+        base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return base != MAP_FAILED;
+    }
+
+    ~MappedFile()
+    {
+        if(base != MAP_FAILED)
+        {
+            munmap(base, bytes);
+        }
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+    }
+};
+
+// Divisor of N closest to sqrt(N) from below, 1 for primes
+size_t splitLength(size_t N)
+{
+    size_t best = 1;
+    for(size_t d = 1; d * d <= N; d++)
+    {
+        if(N % d == 0)
+        {
+            best = d;
+        }
+    }
+    return best;
+}
+
+// Approximate heap bytes of an FFTPlan of length L, plus the scratch that each of threads
+// concurrent Bluestein transforms allocates. Mirrors the tables built by FFTPlan.
+size_t planBytes(size_t L, size_t threads)
+{
+    const bool pow2 = (L & (L - 1)) == 0;
+    if(L <= 1 || (pow2 && L <= 1024))
+    {
+        return 0;
+    }
+    if(pow2)
+    {
+        return L / 2 * sizeof(complex_t) + L * sizeof(size_t);
+    }
+    size_t M = 1;
+    while(M < 2 * L - 1)
+    {
+        M <<= 1;
+    }
+    return (L + M + threads * M) * sizeof(complex_t) + planBytes(M, 0);
+}
+
+// Run job(0 .. count-1) over the worker threads, each thread taking every threads-th job
+template <typename Job>
+void parallelFor(size_t count, size_t threads, const Job& job)
+{
+    if(threads <= 1 || count <= 1)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            job(0, i);
+        }
+        return;
+    }
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads && t < count; t++)
+    {
+        pool.push_back(std::thread([t, count, threads, &job]()
+        {
+            for(size_t i = t; i < count; i += threads)
+            {
+                job(t, i);
+            }
+        }));
+    }
+    for(size_t t = 0; t < pool.size(); t++)
+    {
+        pool[t].join();
+    }
+}
+
+} // namespace
+
+size_t calcFileFFT
+(
+    const std::string& inFilename,
+    const std::string& outFilename,
+    const std::string& path,
+    const FileSampleType type,
+    const bool inverse,
+    const size_t memoryLimit,
+    const size_t threads
+)
+{
+    MappedFile in;
+    if(!in.openRead(path + inFilename))
+    {
+        printf("Error opening file: %s\n", inFilename.c_str());
+        return 0;
+    }
+    const bool isComplex = type == FILE_COMPLEX_F64;
+    const size_t N = in.bytes / (isComplex ? sizeof(complex_t) : sizeof(double));
+    if(N == 0)
+    {
+        printf("Error opening file: %s\n", inFilename.c_str());
+        return 0;
+    }
+
+    // n = N2 * n1 + n2 and k = k1 + N1 * k2
+    const size_t N1 = splitLength(N);
+    const size_t N2 = N / N1;
+
+    // Every thread needs at least one full row (N2 >= N1) next to the plans and twiddles.
+    // Drop threads until that fits, and give up if one thread does not, which happens
+    // when N is prime or nearly so and N2 approaches N.
+    size_t T = threads > 0 ? threads : std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+    size_t fixed = planBytes(N1, T) + planBytes(N2, T) + (N1 + N2) * sizeof(complex_t);
+    while(T > 1 && fixed + T * N2 * sizeof(complex_t) > memoryLimit)
+    {
+        T--;
+        fixed = planBytes(N1, T) + planBytes(N2, T) + (N1 + N2) * sizeof(complex_t);
+    }
+    if(fixed + N2 * sizeof(complex_t) > memoryLimit)
+    {
+        printf("Error: %zu point FFT splits as %zu x %zu and needs %zu MB, above the %zu MB limit\n",
+               N, N1, N2, (fixed + N2 * sizeof(complex_t)) >> 20, memoryLimit >> 20);
+        return 0;
+    }
+    const size_t budget = (memoryLimit - fixed) / T / sizeof(complex_t);
+    const size_t B = std::min(N2, std::max<size_t>(budget / N1, 1));
+    const size_t R = std::min(N1, std::max<size_t>(budget / N2, 1));
+
+    const std::string scratchName = path + outFilename + ".tmp";
+    MappedFile out;
+    MappedFile scratch;
+    if(!out.create(path + outFilename, N * sizeof(complex_t)) || !scratch.create(scratchName, N * sizeof(complex_t)))
+    {
+        printf("Error creating file: %s\n", outFilename.c_str());
+        unlink(scratchName.c_str());
+        return 0;
+    }
+    // The mapping keeps the scratch space alive, and nothing is left behind if we are interrupted
+    unlink(scratchName.c_str());
+    const double* xr = (const double*)in.base;
+    const complex_t* xc = (const complex_t*)in.base;
+    complex_t* Z = (complex_t*)scratch.base;
+    complex_t* X = (complex_t*)out.base;
+
+    const FFTPlan plan1(N1);
+    const FFTPlan plan2(N2);
+    // e^(-j*2*pi*m/N) for m = q * N1 + r is the product of these two entries
+    const double sign = inverse ? 1.0 : -1.0;
+    std::vector<complex_t> coarse(N2);
+    std::vector<complex_t> fine(N1);
+    for(size_t q = 0; q < N2; q++)
+    {
+        double theta = 2.0 * M_PI * (double)q / (double)N2;
+        coarse[q] = complex_t(std::cos(theta), sign * std::sin(theta));
+    }
+    for(size_t r = 0; r < N1; r++)
+    {
+        double theta = 2.0 * M_PI * (double)r / (double)N;
+        fine[r] = complex_t(std::cos(theta), sign * std::sin(theta));
+    }
+
+    std::vector<std::vector<complex_t> > panels(std::min(T, std::max((N2 + B - 1) / B, (N1 + R - 1) / R)));
+
+    // Columns: gather B columns, FFT them, twiddle, and scatter them as rows of Z
+    parallelFor((N2 + B - 1) / B, T, [&](size_t t, size_t p)
+    {
+        const size_t c0 = p * B;
+        const size_t cols = std::min(B, N2 - c0);
+        std::vector<complex_t>& buf = panels[t];
+        buf.resize(cols * N1);
+
+        for(size_t r0 = 0; r0 < N1; r0 += OOC_TILE)
+        {
+            const size_t r1 = std::min(r0 + OOC_TILE, N1);
+            for(size_t b = 0; b < cols; b++)
+            {
+                complex_t* dst = buf.data() + b * N1;
+                for(size_t n1 = r0; n1 < r1; n1++)
+                {
+                    const size_t s = N2 * n1 + c0 + b;
+                    dst[n1] = isComplex ? xc[s] : complex_t(xr[s], 0.0);
+                }
+            }
+        }
+
+        for(size_t b = 0; b < cols; b++)
+        {
+            complex_t* col = buf.data() + b * N1;
+            if(inverse)
+            {
+                plan1.inverse(col);
+            }
+            else
+            {
+                plan1.forward(col);
+            }
+            const size_t n2 = c0 + b;
+            for(size_t k1 = 1; k1 < N1; k1++)
+            {
+                const size_t m = n2 * k1;
+                const complex_t& a = coarse[m / N1];
+                const complex_t& w = fine[m % N1];
+                const complex_t tw(a.re * w.re - a.im * w.im, a.re * w.im + a.im * w.re);
+                const complex_t v = col[k1];
+                col[k1] = complex_t(v.re * tw.re - v.im * tw.im, v.re * tw.im + v.im * tw.re);
+            }
+        }
+
+        for(size_t k0 = 0; k0 < N1; k0 += OOC_TILE)
+        {
+            const size_t k1End = std::min(k0 + OOC_TILE, N1);
+            for(size_t k1 = k0; k1 < k1End; k1++)
+            {
+                complex_t* dst = Z + k1 * N2 + c0;
+                for(size_t b = 0; b < cols; b++)
+                {
+                    dst[b] = buf[b * N1 + k1];
+                }
+            }
+        }
+    });
+
+    // Rows: load R rows of Z, FFT them, and scatter them down the columns of X
+    parallelFor((N1 + R - 1) / R, T, [&](size_t t, size_t p)
+    {
+        const size_t k0 = p * R;
+        const size_t rows = std::min(R, N1 - k0);
+        std::vector<complex_t>& buf = panels[t];
+        buf.resize(rows * N2);
+        std::copy(Z + k0 * N2, Z + (k0 + rows) * N2, buf.begin());
+
+        for(size_t r = 0; r < rows; r++)
+        {
+            if(inverse)
+            {
+                plan2.inverse(buf.data() + r * N2);
+            }
+            else
+            {
+                plan2.forward(buf.data() + r * N2);
+            }
+        }
+
+        for(size_t q0 = 0; q0 < N2; q0 += OOC_TILE)
+        {
+            const size_t q1 = std::min(q0 + OOC_TILE, N2);
+            for(size_t k2 = q0; k2 < q1; k2++)
+            {
+                complex_t* dst = X + N1 * k2 + k0;
+                for(size_t r = 0; r < rows; r++)
+                {
+                    dst[r] = buf[r * N2 + k2];
+                }
+            }
+        }
+    });
+
+    return N;
+}
@@ -0,0 +1,64 @@
+/*************  ✨ Out-of-core FFT 🌟  *************/
+/**
+ * \file outofcore.h
+ * \brief FFTs of signal files too large to hold in memory
+ */
+
+#ifndef OUTOFCORE_H
+#define OUTOFCORE_H
+
+#include <stddef.h>
+#include <string>
+
+/**
+ * \brief Sample format of a raw binary signal file
+ */
+enum FileSampleType
+{
+    /** Real float64 samples */
+    FILE_REAL_F64,
+    /** Interleaved (re, im) float64 pairs, the layout of complex_t */
+    FILE_COMPLEX_F64
+};
+
+/**
+ * \brief Compute one long FFT of a signal file without loading it into memory
+ *
+ * Uses the four-step algorithm: N is split as N1 x N2 with N1 near sqrt(N), the signal is
+ * viewed as an N1 x N2 matrix, and the transform becomes
+ *   1. N2 FFTs of length N1 down the columns,
+ *   2. multiplication by the twiddles e^(-j*2*pi*n2*k1/N),
+ *   3. N1 FFTs of length N2 along the rows of the transposed result.
+ * Input, output and an intermediate scratch file (outFilename + ".tmp", unlinked as
+ * soon as it is mapped) are memory-mapped. Columns and rows are streamed through panel
+ * buffers with cache-blocked transposes, and panels are spread over worker threads.
+ *
+ * RAM use, the panels plus the sub-FFT plans and two twiddle tables, is bounded by
+ * memoryLimit. Mapped file pages live in the page cache, which the kernel reclaims as
+ * needed. Each thread needs at least one full row of N2 samples, so fewer threads are
+ * used when memoryLimit is tight. A prime or nearly prime N has N2 close to N, and if a
+ * single row with its plan does not fit the call fails instead of exceeding the limit.
+ *
+ * @param inFilename Signal file, raw binary in the given format
+ * @param outFilename Output file, N interleaved complex float64 bins
+ * @param path Path to both files
+ * @param type Sample format of the input file
+ * @param inverse Compute the inverse transform, scaled by 1/N
+ * @param memoryLimit Bytes of panels, plans and twiddle tables shared by all threads
+ * @param threads Worker threads, 0 for one per core
+ *
+ * @return The transform length N, or 0 on error, including when N cannot be split to
+ *         fit memoryLimit
+ */
+size_t calcFileFFT
+(
+    const std::string& inFilename,
+    const std::string& outFilename,
+    const std::string& path,
+    const FileSampleType type,
+    const bool inverse = false,
+    const size_t memoryLimit = (size_t)256 << 20,
+    const size_t threads = 0
+);
+
+#endif
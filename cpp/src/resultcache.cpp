@@ -0,0 +1,317 @@
+#include "resultcache.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+
+namespace
+{
+
+const uint64_t XXH_P1 = 11400714785074694791ULL;
+const uint64_t XXH_P2 = 14029467366897019727ULL;
+const uint64_t XXH_P3 = 1609587929392839161ULL;
+const uint64_t XXH_P4 = 9650029242287828579ULL;
+const uint64_t XXH_P5 = 2870177450012600261ULL;
+
+// Header of a disk tier file: magic, key, element size, element count
+const char CACHE_MAGIC[8] = {'D', 'S', 'P', 'R', 'C', '0', '0', '1'};
+const size_t CACHE_HEADER = 32;
+
+inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const unsigned char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input)
+{
+    acc += input * XXH_P2;
+    acc = rotl(acc, 31);
+    return acc * XXH_P1;
+}
+
+inline uint64_t xxhMerge(uint64_t acc, uint64_t val)
+{
+    acc ^= xxhRound(0, val);
+    return acc * XXH_P1 + XXH_P4;
+}
+
+} // namespace
+
+uint64_t hashBuffer
+(
+    const void* data,
+    const size_t bytes,
+    const uint64_t seed
+)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + bytes;
+    uint64_t h;
+
+    if(bytes >= 32)
+    {
+        // Four independent lanes, one 8-byte word each per 32-byte stripe
+        uint64_t v1 = seed + XXH_P1 + XXH_P2;
+        uint64_t v2 = seed + XXH_P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_P1;
+        const unsigned char* limit = end - 32;
+        do
+        {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        }
+        while(p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = xxhMerge(h, v1);
+        h = xxhMerge(h, v2);
+        h = xxhMerge(h, v3);
+        h = xxhMerge(h, v4);
+    }
+    else
+    {
+        h = seed + XXH_P5;
+    }
+    h += (uint64_t)bytes;
+
+    for(; p + 8 <= end; p += 8)
+    {
+        h ^= xxhRound(0, read64(p));
+        h = rotl(h, 27) * XXH_P1 + XXH_P4;
+    }
+    if(p + 4 <= end)
+    {
+        h ^= (uint64_t)read32(p) * XXH_P1;
+        h = rotl(h, 23) * XXH_P2 + XXH_P3;
+        p += 4;
+    }
+    for(; p < end; p++)
+    {
+        h ^= (uint64_t)(*p) * XXH_P5;
+        h = rotl(h, 11) * XXH_P1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_P2;
+    h ^= h >> 29;
+    h *= XXH_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t cacheKey
+(
+    const std::string& op,
+    const uint64_t inputHash,
+    const std::vector<double>& params
+)
+{
+    uint64_t h = hashBuffer(op.data(), op.size(), inputHash);
+    return hashBuffer(params.data(), params.size() * sizeof(double), h);
+}
+
+ResultCache::ResultCache(size_t memoryLimit, const std::string& directory)
+    : limit(memoryLimit),
+      used(0),
+      dir(directory),
+      hitCount(0),
+      missCount(0)
+{
+}
+
+std::string ResultCache::fileName(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return dir + name;
+}
+
+size_t ResultCache::hits() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return hitCount;
+}
+
+size_t ResultCache::misses() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return missCount;
+}
+
+void ResultCache::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    lru.clear();
+    used = 0;
+}
+
+void ResultCache::insertMemory(uint64_t key, size_t elementSize, const Bytes& bytes)
+{
+    std::unordered_map<uint64_t, Entry>::iterator it = entries.find(key);
+    if(it != entries.end())
+    {
+        used -= it->second.bytes->size();
+        lru.erase(it->second.order);
+        entries.erase(it);
+    }
+    if(bytes->size() > limit)
+    {
+        return;
+    }
+    while(used + bytes->size() > limit && !lru.empty())
+    {
+        std::unordered_map<uint64_t, Entry>::iterator victim = entries.find(lru.back());
+        used -= victim->second.bytes->size();
+        entries.erase(victim);
+        lru.pop_back();
+    }
+    lru.push_front(key);
+    Entry& e = entries[key];
+    e.elementSize = elementSize;
+    e.bytes = bytes;
+    e.order = lru.begin();
+    used += bytes->size();
+}
+
+ResultCache::Bytes ResultCache::getBytes(uint64_t key, size_t elementSize)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unordered_map<uint64_t, Entry>::iterator it = entries.find(key);
+        if(it != entries.end() && it->second.elementSize == elementSize)
+        {
+            lru.splice(lru.begin(), lru, it->second.order);
+            hitCount++;
+            return it->second.bytes;
+        }
+    }
+
+    Bytes found;
+    if(!dir.empty())
+    {
+        int fd = open(fileName(key).c_str(), O_RDONLY);
+        struct stat st;
+        if(fd >= 0 && fstat(fd, &st) == 0 && (size_t)st.st_size >= CACHE_HEADER)
+        {
+            const size_t size = (size_t)st.st_size;
+            void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            if(base != MAP_FAILED)
+            {
+                const char* p = (const char*)base;
+                uint64_t header[3];
+                memcpy(header, p + 8, sizeof(header));
+                if(memcmp(p, CACHE_MAGIC, 8) == 0 && header[0] == key && header[1] == elementSize
+                   && CACHE_HEADER + header[1] * header[2] == size)
+                {
+                    // Copied once out of the mapping, then shared by the memory tier and the caller
+                    found = std::make_shared<const std::vector<char> >(p + CACHE_HEADER, p + size);
+                }
+                munmap(base, size);
+            }
+        }
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    if(found)
+    {
+        insertMemory(key, elementSize, found);
+        hitCount++;
+    }
+    else
+    {
+        missCount++;
+    }
+    return found;
+}
+
+void ResultCache::putBytes(uint64_t key, size_t elementSize, const Bytes& bytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        insertMemory(key, elementSize, bytes);
+    }
+    if(dir.empty())
+    {
+        return;
+    }
+
+    // Write under a unique temporary name, then rename so readers never see a partial file
+    static std::atomic<unsigned> serial(0);
+    const std::string name = fileName(key);
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".%ld.%u.tmp", (long)getpid(), serial++);
+    const std::string tmp = name + suffix;
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if(fp == NULL)
+    {
+        printf("Error opening file: %s\n", tmp.c_str());
+        return;
+    }
+    const uint64_t header[3] = {key, (uint64_t)elementSize, (uint64_t)(bytes->size() / elementSize)};
+    bool ok = fwrite(CACHE_MAGIC, 1, 8, fp) == 8;
+    ok = ok && fwrite(header, sizeof(header), 1, fp) == 1;
+    ok = ok && fwrite(bytes->data(), 1, bytes->size(), fp) == bytes->size();
+    ok = fclose(fp) == 0 && ok;
+    if(!ok || rename(tmp.c_str(), name.c_str()) != 0)
+    {
+        printf("Error writing file: %s\n", name.c_str());
+        unlink(tmp.c_str());
+    }
+}
+
+std::vector<complex_t> calcSigDFT_f
+(
+    ResultCache& cache,
+    const std::vector<double>& signal,
+    const size_t N
+)
+{
+    const uint64_t key = cacheKey("calcSigDFT_f", hashSignal(signal), std::vector<double>(1, (double)N));
+    return cache.memoize<complex_t>(key, [&]() { return calcSigDFT_f(signal, N); });
+}
+
+std::vector<double> calcDFTMag
+(
+    ResultCache& cache,
+    const std::vector<complex_t>& dft
+)
+{
+    const uint64_t key = cacheKey("calcDFTMag", hashSignal(dft));
+    return cache.memoize<double>(key, [&]() { return calcDFTMag(dft); });
+}
+
+std::vector<double> convolveFull
+(
+    ResultCache& cache,
+    const std::vector<double>& sig,
+    const std::vector<double>& kernel
+)
+{
+    const uint64_t key = cacheKey("convolveFull", hashSignal(kernel, hashSignal(sig)));
+    return cache.memoize<double>(key, [&]() { return convolveFull(sig, kernel); });
+}
@@ -0,0 +1,253 @@
+/*************  ✨ Result Cache 🌟  *************/
+/**
+ * \file resultcache.h
+ * \brief Memoization of expensive library calls keyed by input content and parameters
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "libdsp.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief 64-bit content hash of a buffer, XXH64
+ *
+ * Consumes 32-byte stripes into four independent lanes, so the loop runs at memory
+ * bandwidth on large signals. Results match the reference XXH64 implementation.
+ *
+ * @param data Start of the buffer
+ * @param bytes Buffer length in bytes
+ * @param seed Seed, chain hashes by passing the previous hash
+ *
+ * @return The hash
+ */
+uint64_t hashBuffer
+(
+    const void* data,
+    const size_t bytes,
+    const uint64_t seed = 0
+);
+
+/**
+ * \brief Hash of a signal, including its length and element size
+ *
+ * @param sig Signal
+ * @param seed Seed, chain hashes by passing the previous hash
+ *
+ * @return The hash
+ */
+template <typename T>
+uint64_t hashSignal
+(
+    const std::vector<T>& sig,
+    const uint64_t seed = 0
+)
+{
+    const uint64_t shape[2] = {(uint64_t)sig.size(), (uint64_t)sizeof(T)};
+    return hashBuffer(sig.data(), sig.size() * sizeof(T), hashBuffer(shape, sizeof(shape), seed));
+}
+
+/**
+ * \brief Build a cache key from an operation name, an input hash and numeric parameters
+ *
+ * @param op Name of the operation, keeps different calls on the same input apart
+ * @param inputHash Hash of the inputs, from hashSignal
+ * @param params Parameters that change the result
+ *
+ * @return The key
+ */
+uint64_t cacheKey
+(
+    const std::string& op,
+    const uint64_t inputHash,
+    const std::vector<double>& params = std::vector<double>()
+);
+
+/**
+ * \brief Two-tier cache of result vectors
+ *
+ * The memory tier is an LRU bounded by bytes. The optional disk tier stores one binary
+ * file per key in a directory: the 8 characters "DSPRC001", uint64 key, uint64 element
+ * size, uint64 element count, then the raw elements. Files are written to a temporary
+ * name and renamed, so several processes can share a directory, and are memory-mapped
+ * when read back. Results found on disk are promoted to the memory tier.
+ *
+ * Stored results are immutable and shared, so get copies a result once into the caller's
+ * vector and put copies it once into the cache.
+ *
+ * All methods are thread safe.
+ */
+class ResultCache
+{
+public:
+    /**
+     * \brief Constructor for ResultCache
+     *
+     * @param memoryLimit Bytes of results kept in memory
+     * @param directory Existing directory for the disk tier, with a trailing separator.
+     *                  Empty for a memory only cache.
+     */
+    explicit ResultCache(size_t memoryLimit = (size_t)64 << 20, const std::string& directory = "");
+
+    /**
+     * \brief Look up a result
+     *
+     * @param key Cache key
+     * @param out Filled with the result on a hit
+     *
+     * @return True on a hit
+     */
+    template <typename T>
+    bool get(uint64_t key, std::vector<T>& out)
+    {
+        // The entry is shared with the memory tier, so this is the only copy
+        std::shared_ptr<const std::vector<char> > bytes = getBytes(key, sizeof(T));
+        if(!bytes)
+        {
+            return false;
+        }
+        out.resize(bytes->size() / sizeof(T));
+        std::copy(bytes->begin(), bytes->end(), (char*)out.data());
+        return true;
+    };
+
+    /**
+     * \brief Store a result in both tiers
+     *
+     * @param key Cache key
+     * @param value Result
+     *
+     * @returns void
+     */
+    template <typename T>
+    void put(uint64_t key, const std::vector<T>& value)
+    {
+        // One copy into the memory tier, which the disk tier then writes from
+        const char* p = (const char*)value.data();
+        putBytes(key, sizeof(T), std::make_shared<const std::vector<char> >(p, p + value.size() * sizeof(T)));
+    };
+
+    /**
+     * \brief Return a cached result, or compute and store it
+     *
+     * @param key Cache key
+     * @param compute Callable returning the result as a std::vector<T>
+     *
+     * @return The result
+     */
+    template <typename T, typename F>
+    std::vector<T> memoize(uint64_t key, F compute)
+    {
+        std::vector<T> result;
+        if(!get(key, result))
+        {
+            result = compute();
+            put(key, result);
+        }
+        return result;
+    };
+
+    /**
+     * \brief Drop the memory tier, the disk tier is left alone
+     *
+     * @returns void
+     */
+    void clear();
+
+    /**
+     * \brief Access the number of lookups answered from memory or disk
+     *
+     * @returns The hit count
+     */
+    size_t hits() const;
+
+    /**
+     * \brief Access the number of lookups that missed both tiers
+     *
+     * @returns The miss count
+     */
+    size_t misses() const;
+
+private:
+    // Entries are immutable once stored, so lookups hand out the buffer itself
+    typedef std::shared_ptr<const std::vector<char> > Bytes;
+
+    struct Entry
+    {
+        size_t elementSize;
+        Bytes bytes;
+        std::list<uint64_t>::iterator order;
+    };
+
+    Bytes getBytes(uint64_t key, size_t elementSize);
+    void putBytes(uint64_t key, size_t elementSize, const Bytes& bytes);
+    void insertMemory(uint64_t key, size_t elementSize, const Bytes& bytes);
+    std::string fileName(uint64_t key) const;
+
+    size_t limit;
+    size_t used;
+    std::string dir;
+    // Most recently used key at the front
+    std::list<uint64_t> lru;
+    std::unordered_map<uint64_t, Entry> entries;
+    size_t hitCount;
+    size_t missCount;
+    mutable std::mutex lock;
+};
+
+/**
+ * \brief calcSigDFT_f through a cache
+ *
+ * @param cache Cache to use
+ * @param signal The input signal
+ * @param N The length of the signal
+ *
+ * @return Complex DFT of the signal
+ */
+std::vector<complex_t> calcSigDFT_f
+(
+    ResultCache& cache,
+    const std::vector<double>& signal,
+    const size_t N
+);
+
+/**
+ * \brief calcDFTMag through a cache
+ *
+ * @param cache Cache to use
+ * @param dft The DFT of the signal
+ *
+ * @return A vector of the magnitude of each DFT bin
+ */
+std::vector<double> calcDFTMag
+(
+    ResultCache& cache,
+    const std::vector<complex_t>& dft
+);
+
+/**
+ * \brief convolveFull through a cache
+ *
+ * @param cache Cache to use
+ * @param sig Signal
+ * @param kernel Kernel
+ *
+ * @return Convolved signal
+ */
+std::vector<double> convolveFull
+(
+    ResultCache& cache,
+    const std::vector<double>& sig,
+    const std::vector<double>& kernel
+);
+
+#endif
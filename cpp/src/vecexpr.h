@@ -0,0 +1,366 @@
+/*************  ✨ Vector Expressions 🌟  *************/
+/**
+ * \file vecexpr.h
+ * \brief Lazy element-wise arithmetic over real and complex signals
+ *
+ * Wrapping a signal with vec() gives an expression. Arithmetic on expressions only builds
+ * a small tree of references, and the whole chain runs in one loop when it is evaluated,
+ * with no temporary vectors:
+ *
+ *     std::vector<double> m = mag(vec(a) * conj(vec(b)) + vec(c));
+ *     evalInto(vec(x) * 0.5 - vec(y), out);
+ *
+ * Real and complex operands mix freely, and double or complex_t scalars are broadcast.
+ * The result has the length of the shortest signal in the expression. Expressions hold
+ * references to their signals, so evaluate them before the signals go out of scope.
+ */
+
+#ifndef VECEXPR_H
+#define VECEXPR_H
+
+#include "complextype.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+using namespace complexDSP;
+
+namespace dspExpr
+{
+
+/**
+ * \brief Evaluate the first N elements of an expression into dst
+ *
+ * Four elements are computed before any is stored. Straight-line code like this is packed
+ * into SIMD registers by the -O2 SLP vectorizer, which, unlike the loop vectorizer at -O2,
+ * needs no runtime aliasing checks, and it keeps dst safe to use as an operand.
+ */
+template <typename E, typename V>
+inline void evalRange(const E& e, V* dst, const size_t N)
+{
+    size_t i = 0;
+    for(; i + 4 <= N; i += 4)
+    {
+        const V v0 = e[i];
+        const V v1 = e[i + 1];
+        const V v2 = e[i + 2];
+        const V v3 = e[i + 3];
+        dst[i] = v0;
+        dst[i + 1] = v1;
+        dst[i + 2] = v2;
+        dst[i + 3] = v3;
+    }
+    for(; i < N; i++)
+    {
+        dst[i] = e[i];
+    }
+}
+
+/**
+ * \brief Base of every expression, E is the concrete expression type and V its element type
+ */
+template <typename E, typename V>
+struct VecExpr
+{
+    typedef V value_type;
+
+
+    const E& self() const { return static_cast<const E&>(*this); };
+
+    /**
+     * \brief Evaluate into a new vector
+     *
+     * @returns The evaluated signal
+     */
+    std::vector<V> eval() const
+    {
+        std::vector<V> out(self().size());
+        evalRange(self(), out.data(), out.size());
+        return out;
+    };
+
+    /**
+     * \brief Evaluate on assignment to a vector
+     */
+    operator std::vector<V>() const { return eval(); };
+};
+
+/**
+ * \brief Leaf expression referring to a signal buffer
+ */
+template <typename T>
+struct VecRef : VecExpr<VecRef<T>, T>
+{
+    const T* data;
+    size_t len;
+
+    VecRef(const T* d, size_t n) : data(d), len(n) {}
+    size_t size() const { return len; };
+    T operator[](size_t i) const { return data[i]; };
+};
+
+/**
+ * \brief Leaf expression repeating one value, its length never limits the result
+ */
+template <typename T>
+struct Scalar : VecExpr<Scalar<T>, T>
+{
+    T value;
+
+    explicit Scalar(const T& v) : value(v) {}
+    size_t size() const { return SIZE_MAX; };
+    T operator[](size_t) const { return value; };
+};
+
+/**
+ * \brief Element-wise binary operation
+ */
+template <typename Op, typename L, typename R>
+struct Binary : VecExpr<Binary<Op, L, R>, decltype(Op::apply(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()))>
+{
+    typedef decltype(Op::apply(std::declval<typename L::value_type>(), std::declval<typename R::value_type>())) value_type;
+    // Operands are held by value so temporaries in a chain stay alive; every leaf is only
+    // a pointer and a length, so the copies are cheap
+    const L l;
+    const R r;
+
+    Binary(const L& a, const R& b) : l(a), r(b) {}
+    size_t size() const { return l.size() < r.size() ? l.size() : r.size(); };
+    value_type operator[](size_t i) const { return Op::apply(l[i], r[i]); };
+};
+
+/**
+ * \brief Element-wise unary operation
+ */
+template <typename Op, typename E>
+struct Unary : VecExpr<Unary<Op, E>, decltype(Op::apply(std::declval<typename E::value_type>()))>
+{
+    typedef decltype(Op::apply(std::declval<typename E::value_type>())) value_type;
+    const E e;
+
+    explicit Unary(const E& a) : e(a) {}
+    size_t size() const { return e.size(); };
+    value_type operator[](size_t i) const { return Op::apply(e[i]); };
+};
+
+// Element operations, spelled out on re/im so mixed real and complex operands need no promotion
+
+struct AddOp
+{
+    static double apply(double a, double b) { return a + b; };
+    static complex_t apply(const complex_t& a, const complex_t& b) { return complex_t(a.re + b.re, a.im + b.im); };
+    static complex_t apply(const complex_t& a, double b) { return complex_t(a.re + b, a.im); };
+    static complex_t apply(double a, const complex_t& b) { return complex_t(a + b.re, b.im); };
+};
+
+struct SubOp
+{
+    static double apply(double a, double b) { return a - b; };
+    static complex_t apply(const complex_t& a, const complex_t& b) { return complex_t(a.re - b.re, a.im - b.im); };
+    static complex_t apply(const complex_t& a, double b) { return complex_t(a.re - b, a.im); };
+    static complex_t apply(double a, const complex_t& b) { return complex_t(a - b.re, -b.im); };
+};
+
+struct MulOp
+{
+    static double apply(double a, double b) { return a * b; };
+    static complex_t apply(const complex_t& a, const complex_t& b) { return complex_t(a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re); };
+    static complex_t apply(const complex_t& a, double b) { return complex_t(a.re * b, a.im * b); };
+    static complex_t apply(double a, const complex_t& b) { return complex_t(a * b.re, a * b.im); };
+};
+
+struct DivOp
+{
+    static double apply(double a, double b) { return a / b; };
+    static complex_t apply(const complex_t& a, const complex_t& b)
+    {
+        const double d = b.re * b.re + b.im * b.im;
+        return complex_t((a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d);
+    };
+    static complex_t apply(const complex_t& a, double b) { return complex_t(a.re / b, a.im / b); };
+    static complex_t apply(double a, const complex_t& b)
+    {
+        const double d = b.re * b.re + b.im * b.im;
+        return complex_t(a * b.re / d, -a * b.im / d);
+    };
+};
+
+struct NegOp
+{
+    static double apply(double a) { return -a; };
+    static complex_t apply(const complex_t& a) { return complex_t(-a.re, -a.im); };
+};
+
+struct ConjOp
+{
+    static double apply(double a) { return a; };
+    static complex_t apply(const complex_t& a) { return complex_t(a.re, -a.im); };
+};
+
+struct SqMagOp
+{
+    static double apply(double a) { return a * a; };
+    static double apply(const complex_t& a) { return a.re * a.re + a.im * a.im; };
+};
+
+struct MagOp
+{
+    static double apply(double a) { return std::fabs(a); };
+    static double apply(const complex_t& a) { return std::sqrt(a.re * a.re + a.im * a.im); };
+};
+
+struct RealOp
+{
+    static double apply(double a) { return a; };
+    static double apply(const complex_t& a) { return a.re; };
+};
+
+struct ImagOp
+{
+    static double apply(double) { return 0.0; };
+    static double apply(const complex_t& a) { return a.im; };
+};
+
+struct AngleOp
+{
+    static double apply(double a) { return a < 0.0 ? M_PI : 0.0; };
+    static double apply(const complex_t& a) { return std::atan2(a.im, a.re); };
+};
+
+// Binary operators between two expressions, or an expression and a broadcast scalar
+
+#define DSP_EXPR_BINARY(OPERATOR, OP)                                                           \
+template <typename L, typename LV, typename R, typename RV>                                     \
+Binary<OP, L, R> OPERATOR(const VecExpr<L, LV>& a, const VecExpr<R, RV>& b)                     \
+{                                                                                               \
+    return Binary<OP, L, R>(a.self(), b.self());                                                \
+}                                                                                               \
+template <typename L, typename LV>                                                              \
+Binary<OP, L, Scalar<double> > OPERATOR(const VecExpr<L, LV>& a, double b)                      \
+{                                                                                               \
+    return Binary<OP, L, Scalar<double> >(a.self(), Scalar<double>(b));                         \
+}                                                                                               \
+template <typename R, typename RV>                                                              \
+Binary<OP, Scalar<double>, R> OPERATOR(double a, const VecExpr<R, RV>& b)                       \
+{                                                                                               \
+    return Binary<OP, Scalar<double>, R>(Scalar<double>(a), b.self());                          \
+}                                                                                               \
+template <typename L, typename LV>                                                              \
+Binary<OP, L, Scalar<complex_t> > OPERATOR(const VecExpr<L, LV>& a, const complex_t& b)         \
+{                                                                                               \
+    return Binary<OP, L, Scalar<complex_t> >(a.self(), Scalar<complex_t>(b));                   \
+}                                                                                               \
+template <typename R, typename RV>                                                              \
+Binary<OP, Scalar<complex_t>, R> OPERATOR(const complex_t& a, const VecExpr<R, RV>& b)          \
+{                                                                                               \
+    return Binary<OP, Scalar<complex_t>, R>(Scalar<complex_t>(a), b.self());                    \
+}
+
+DSP_EXPR_BINARY(operator+, AddOp)
+DSP_EXPR_BINARY(operator-, SubOp)
+DSP_EXPR_BINARY(operator*, MulOp)
+DSP_EXPR_BINARY(operator/, DivOp)
+
+#undef DSP_EXPR_BINARY
+
+#define DSP_EXPR_UNARY(NAME, OP)                                                                \
+template <typename E, typename V>                                                               \
+Unary<OP, E> NAME(const VecExpr<E, V>& a)                                                       \
+{                                                                                               \
+    return Unary<OP, E>(a.self());                                                              \
+}
+
+DSP_EXPR_UNARY(operator-, NegOp)
+DSP_EXPR_UNARY(conj, ConjOp)
+DSP_EXPR_UNARY(sqmag, SqMagOp)
+DSP_EXPR_UNARY(mag, MagOp)
+DSP_EXPR_UNARY(real, RealOp)
+DSP_EXPR_UNARY(imag, ImagOp)
+DSP_EXPR_UNARY(angle, AngleOp)
+
+#undef DSP_EXPR_UNARY
+
+} // namespace dspExpr
+
+/**
+ * \brief Wrap a signal as an expression leaf
+ *
+ * @param sig Signal, referenced rather than copied
+ *
+ * @return The expression
+ */
+template <typename T>
+dspExpr::VecRef<T> vec
+(
+    const std::vector<T>& sig
+)
+{
+    return dspExpr::VecRef<T>(sig.data(), sig.size());
+}
+
+/**
+ * \brief Wrap a raw buffer as an expression leaf
+ *
+ * @param data Start of the buffer
+ * @param len Number of elements
+ *
+ * @return The expression
+ */
+template <typename T>
+dspExpr::VecRef<T> vec
+(
+    const T* data,
+    const size_t len
+)
+{
+    return dspExpr::VecRef<T>(data, len);
+}
+
+/**
+ * \brief Evaluate an expression into a new vector
+ *
+ * @param expr Expression
+ *
+ * @return The evaluated signal
+ */
+template <typename E, typename V>
+std::vector<V> eval
+(
+    const dspExpr::VecExpr<E, V>& expr
+)
+{
+    return expr.eval();
+}
+
+/**
+ * \brief Evaluate an expression into an existing vector, reusing its storage
+ *
+ * The destination may also appear in the expression, as every element only depends on
+ * the same index of its operands.
+ *
+ * @param expr Expression
+ * @param out Destination, resized to the expression length
+ *
+ * @returns void
+ */
+template <typename E, typename V>
+void evalInto
+(
+    const dspExpr::VecExpr<E, V>& expr,
+    std::vector<V>& out
+)
+{
+    const E& e = expr.self();
+    const size_t N = e.size();
+    // Read the length before resizing, the destination may be an operand
+    if(out.size() != N)
+    {
+        std::vector<V> tmp = e.eval();
+        out.swap(tmp);
+        return;
+    }
+    dspExpr::evalRange(e, out.data(), N);
+}
+
+#endif
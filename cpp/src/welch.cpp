@@ -0,0 +1,312 @@
+#include "welch.h"
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+
+// Segments computed per thread before merging, bounds the scratch memory
+const size_t WELCH_BATCH_PER_THREAD = 16;
+
+inline complex_t toComplexSample(const double& x)
+{
+    return complex_t(x, 0.0);
+}
+
+inline const complex_t& toComplexSample(const complex_t& x)
+{
+    return x;
+}
+
+// Ratio of the sample median to the mean of n chi-squared (2 DOF) periodogram values
+double medianBias(size_t n)
+{
+    double bias = 1.0;
+    for(size_t k = 1; 2 * k + 1 <= n; k++)
+    {
+        bias += 1.0 / (double)(2 * k + 1) - 1.0 / (double)(2 * k);
+    }
+    return bias;
+}
+
+// Number of segments calcWelchPSD takes from a signal of n samples
+size_t welchSegments(size_t n, size_t segment, size_t overlap)
+{
+    const size_t N = segment > 0 ? segment : 1;
+    const size_t hop = overlap < N ? N - overlap : 1;
+    return n >= N ? (n - N) / hop + 1 : 1;
+}
+
+} // namespace
+
+WelchPSD::WelchPSD
+(
+    const std::vector<double>& window,
+    size_t overlap,
+    WelchAverage average,
+    double sampleRate,
+    double alpha,
+    size_t medianSegments
+)
+    : plan(window.size()),
+      win(window.empty() ? std::vector<double>(1, 1.0) : window),
+      hop(overlap < win.size() ? win.size() - overlap : 1),
+      mode(average),
+      alpha(alpha > 0.0 && alpha <= 1.0 ? alpha : 0.1),
+      historyLimit(medianSegments > 0 ? medianSegments : 1)
+{
+    double winPower = 0.0;
+    for(size_t i = 0; i < win.size(); i++)
+    {
+        winPower += win[i] * win[i];
+    }
+    scale = 1.0 / (sampleRate * winPower);
+    reset();
+}
+
+void WelchPSD::reset()
+{
+    pending.clear();
+    count = 0;
+    sum.assign(win.size(), 0.0);
+    ema.assign(win.size(), 0.0);
+    history.clear();
+    historyNext = 0;
+}
+
+template <typename T>
+void WelchPSD::periodogram(size_t start, const T* in, std::vector<complex_t>& work, double* power) const
+{
+    // The segment starts in the buffered tail of the previous block, or in the input
+    const size_t N = win.size();
+    const size_t P = pending.size();
+    size_t i = 0;
+    for(; start + i < P && i < N; i++)
+    {
+        work[i].re = pending[start + i].re * win[i];
+        work[i].im = pending[start + i].im * win[i];
+    }
+    const T* x = in + (start + i - P);
+    for(; i < N; i++, x++)
+    {
+        const complex_t v = toComplexSample(*x);
+        work[i].re = v.re * win[i];
+        work[i].im = v.im * win[i];
+    }
+    plan.forward(work.data());
+    for(size_t k = 0; k < N; k++)
+    {
+        power[k] = work[k].re * work[k].re + work[k].im * work[k].im;
+    }
+}
+
+void WelchPSD::accumulate(const double* power)
+{
+    const size_t N = win.size();
+    switch(mode)
+    {
+        case WELCH_MEAN:
+            for(size_t k = 0; k < N; k++)
+            {
+                sum[k] += power[k];
+            }
+            break;
+        case WELCH_MEDIAN:
+            // Keep the newest historyLimit periodograms, overwriting the oldest
+            if(history.size() < historyLimit)
+            {
+                history.push_back(std::vector<double>(power, power + N));
+            }
+            else
+            {
+                std::copy(power, power + N, history[historyNext].begin());
+                historyNext = (historyNext + 1) % historyLimit;
+            }
+            break;
+        case WELCH_EXPONENTIAL:
+            for(size_t k = 0; k < N; k++)
+            {
+                ema[k] = count == 0 ? power[k] : ema[k] + alpha * (power[k] - ema[k]);
+            }
+            break;
+    }
+    count++;
+}
+
+template <typename T>
+void WelchPSD::run(const T* in, size_t L, size_t threads)
+{
+    const size_t N = win.size();
+    if(threads == 0)
+    {
+        threads = std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Segments are read in place from the buffered tail followed by the new block
+    const size_t P = pending.size();
+    size_t total = P + L >= N ? (P + L - N) / hop + 1 : 0;
+    const size_t batch = threads * WELCH_BATCH_PER_THREAD;
+    std::vector<double> power(std::min(total, batch) * N);
+    std::vector<std::vector<complex_t> > work(threads, std::vector<complex_t>(N));
+
+    for(size_t first = 0; first < total; first += batch)
+    {
+        const size_t n = std::min(batch, total - first);
+
+        // Periodograms are independent, compute them in parallel
+        if(threads == 1 || n == 1)
+        {
+            for(size_t s = 0; s < n; s++)
+            {
+                periodogram((first + s) * hop, in, work[0], &power[s * N]);
+            }
+        }
+        else
+        {
+            std::vector<std::thread> pool;
+            for(size_t t = 0; t < threads && t < n; t++)
+            {
+                pool.push_back(std::thread([this, t, n, first, threads, N, in, &power, &work]()
+                {
+                    for(size_t s = t; s < n; s += threads)
+                    {
+                        periodogram((first + s) * hop, in, work[t], &power[s * N]);
+                    }
+                }));
+            }
+            for(size_t t = 0; t < pool.size(); t++)
+            {
+                pool[t].join();
+            }
+        }
+
+        // Merge strictly in segment order so the result does not depend on the thread count
+        for(size_t s = 0; s < n; s++)
+        {
+            accumulate(&power[s * N]);
+        }
+    }
+
+    // Keep only what follows the last segment start, fewer than N samples
+    const size_t used = total * hop;
+    pending.erase(pending.begin(), pending.begin() + std::min(used, P));
+    for(size_t i = used > P ? used - P : 0; i < L; i++)
+    {
+        pending.push_back(toComplexSample(in[i]));
+    }
+}
+
+void WelchPSD::process(const std::vector<double>& in, size_t threads)
+{
+    run(in.data(), in.size(), threads);
+}
+
+void WelchPSD::process(const std::vector<complex_t>& in, size_t threads)
+{
+    run(in.data(), in.size(), threads);
+}
+
+void WelchPSD::process(const double* in, size_t n, size_t threads)
+{
+    run(in, n, threads);
+}
+
+void WelchPSD::process(const complex_t* in, size_t n, size_t threads)
+{
+    run(in, n, threads);
+}
+
+std::vector<double> WelchPSD::psd() const
+{
+    const size_t N = win.size();
+    if(count == 0)
+    {
+        return std::vector<double>();
+    }
+
+    std::vector<double> out(N);
+    switch(mode)
+    {
+        case WELCH_MEAN:
+            for(size_t k = 0; k < N; k++)
+            {
+                out[k] = sum[k] * scale / (double)count;
+            }
+            break;
+        case WELCH_MEDIAN:
+        {
+            const size_t M = history.size();
+            std::vector<double> bin(M);
+            const double bias = medianBias(M);
+            for(size_t k = 0; k < N; k++)
+            {
+                for(size_t s = 0; s < M; s++)
+                {
+                    bin[s] = history[s][k];
+                }
+                size_t mid = M / 2;
+                std::nth_element(bin.begin(), bin.begin() + mid, bin.end());
+                double median = bin[mid];
+                if(M % 2 == 0)
+                {
+                    median = 0.5 * (median + *std::max_element(bin.begin(), bin.begin() + mid));
+                }
+                out[k] = median * scale / bias;
+            }
+            break;
+        }
+        case WELCH_EXPONENTIAL:
+            for(size_t k = 0; k < N; k++)
+            {
+                out[k] = ema[k] * scale;
+            }
+            break;
+    }
+    return out;
+}
+
+std::vector<double> calcWelchPSD
+(
+    const double* sig,
+    const size_t n,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average,
+    const double sampleRate,
+    const size_t threads
+)
+{
+    // The whole signal is known, so the median covers every segment
+    WelchPSD est(window, overlap, average, sampleRate, 0.1, welchSegments(n, window.size(), overlap));
+    est.process(sig, n, threads);
+    return est.psd();
+}
+
+std::vector<double> calcWelchPSD
+(
+    const std::vector<double>& sig,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average,
+    const double sampleRate,
+    const size_t threads
+)
+{
+    return calcWelchPSD(sig.data(), sig.size(), window, overlap, average, sampleRate, threads);
+}
+
+std::vector<double> calcWelchPSD
+(
+    const std::vector<complex_t>& sig,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average,
+    const double sampleRate,
+    const size_t threads
+)
+{
+    // The whole signal is known, so the median covers every segment
+    WelchPSD est(window, overlap, average, sampleRate, 0.1, welchSegments(sig.size(), window.size(), overlap));
+    est.process(sig, threads);
+    return est.psd();
+}
@@ -0,0 +1,227 @@
+/*************  ✨ Welch Power Spectral Density 🌟  *************/
+/**
+ * \file welch.h
+ * \brief Averaged periodogram (Welch) power spectral density estimation
+ */
+
+#ifndef WELCH_H
+#define WELCH_H
+
+#include "libdsp.h"
+#include "fftplan.h"
+#include "window.h"
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief How segment periodograms are combined
+ */
+enum WelchAverage
+{
+    /** Arithmetic mean of all segments */
+    WELCH_MEAN,
+    /** Per-bin median of the most recent segments, corrected for the median bias. Robust
+     *  to bursts. Keeps up to medianSegments periodograms. */
+    WELCH_MEDIAN,
+    /** Exponentially weighted average, recent segments weigh the most */
+    WELCH_EXPONENTIAL
+};
+
+/**
+ * \brief Streaming Welch power spectral density estimator
+ *
+ * Splits the input into overlapping segments, windows each one, transforms it with a
+ * single reusable FFT plan and accumulates the power |X|^2 in place. Input may arrive in
+ * blocks of any size. Segments are read straight from each block, and only the samples
+ * after the last segment start (fewer than one segment) are kept for the next block, so
+ * memory does not grow with the stream and the estimate only depends on the
+ * concatenated input.
+ *
+ * Segment periodograms can be computed on several threads. They are always merged in
+ * segment order, so the estimate is bit for bit the same for any thread count.
+ */
+class WelchPSD
+{
+public:
+    /**
+     * \brief Constructor for WelchPSD
+     *
+     * @param window Window applied to each segment, its length sets the segment length
+     * @param overlap Number of samples shared by consecutive segments, less than the segment length
+     * @param average Averaging mode
+     * @param sampleRate Sample rate, used to scale the result to power per unit frequency
+     * @param alpha Weight of the newest segment in WELCH_EXPONENTIAL mode, in (0, 1]
+     * @param medianSegments Number of most recent periodograms the WELCH_MEDIAN estimate
+     *                       is taken over, which bounds its memory on a stream
+     */
+    WelchPSD
+    (
+        const std::vector<double>& window,
+        size_t overlap,
+        WelchAverage average = WELCH_MEAN,
+        double sampleRate = 1.0,
+        double alpha = 0.1,
+        size_t medianSegments = 256
+    );
+
+    /**
+     * \brief Add a block of real samples
+     *
+     * @param in Input block
+     * @param threads Number of threads used for the periodograms, 0 for one per core
+     *
+     * @returns void
+     */
+    void process(const std::vector<double>& in, size_t threads = 1);
+
+    /**
+     * \brief Add a block of complex samples
+     *
+     * @param in Input block
+     * @param threads Number of threads used for the periodograms, 0 for one per core
+     *
+     * @returns void
+     */
+    void process(const std::vector<complex_t>& in, size_t threads = 1);
+
+    /**
+     * \brief Add a block of real samples from a caller owned buffer
+     *
+     * Segments are read straight from in, only the tail that does not fill a segment yet
+     * is kept.
+     *
+     * @param in n samples
+     * @param n Block length
+     * @param threads Number of threads used for the periodograms, 0 for one per core
+     *
+     * @returns void
+     */
+    void process(const double* in, size_t n, size_t threads = 1);
+
+    /**
+     * \brief Add a block of complex samples from a caller owned buffer
+     *
+     * @param in n samples
+     * @param n Block length
+     * @param threads Number of threads used for the periodograms, 0 for one per core
+     *
+     * @returns void
+     */
+    void process(const complex_t* in, size_t n, size_t threads = 1);
+
+    /**
+     * \brief Compute the current estimate
+     *
+     * @return Two-sided power spectral density, one value per FFT bin in the same order as
+     *         calcSigDFT_f. Empty if no segment has completed yet.
+     */
+    std::vector<double> psd() const;
+
+    /**
+     * \brief Access the number of segments averaged so far
+     *
+     * @returns The segment count
+     */
+    size_t segments() const { return count; };
+
+    /**
+     * \brief Discard the estimate and any buffered samples
+     *
+     * @returns void
+     */
+    void reset();
+
+private:
+    template <typename T>
+    void run(const T* in, size_t L, size_t threads);
+    template <typename T>
+    void periodogram(size_t start, const T* in, std::vector<complex_t>& work, double* power) const;
+    void accumulate(const double* power);
+
+    FFTPlan plan;
+    std::vector<double> win;
+    size_t hop;
+    WelchAverage mode;
+    double scale;
+    double alpha;
+    size_t historyLimit;
+
+    // Samples after the last segment start, always fewer than one segment
+    std::vector<complex_t> pending;
+    size_t count;
+    std::vector<double> sum;
+    std::vector<double> ema;
+    // Ring of the newest periodograms for WELCH_MEDIAN, historyNext is the oldest once full
+    std::vector<std::vector<double> > history;
+    size_t historyNext;
+};
+
+/**
+ * \brief Welch power spectral density of a whole real signal in a caller owned buffer
+ *
+ * @param sig n samples
+ * @param n Signal length
+ * @param window Window applied to each segment, its length sets the segment length
+ * @param overlap Number of samples shared by consecutive segments
+ * @param average Averaging mode
+ * @param sampleRate Sample rate
+ * @param threads Number of threads, 0 for one per core
+ *
+ * @return Two-sided power spectral density, one value per FFT bin
+ */
+std::vector<double> calcWelchPSD
+(
+    const double* sig,
+    const size_t n,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average = WELCH_MEAN,
+    const double sampleRate = 1.0,
+    const size_t threads = 0
+);
+
+/**
+ * \brief Welch power spectral density of a whole real signal
+ *
+ * @param sig Signal
+ * @param window Window applied to each segment, its length sets the segment length
+ * @param overlap Number of samples shared by consecutive segments
+ * @param average Averaging mode
+ * @param sampleRate Sample rate
+ * @param threads Number of threads, 0 for one per core
+ *
+ * @return Two-sided power spectral density, one value per FFT bin
+ */
+std::vector<double> calcWelchPSD
+(
+    const std::vector<double>& sig,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average = WELCH_MEAN,
+    const double sampleRate = 1.0,
+    const size_t threads = 0
+);
+
+/**
+ * \brief Welch power spectral density of a whole complex signal
+ *
+ * @param sig Signal
+ * @param window Window applied to each segment, its length sets the segment length
+ * @param overlap Number of samples shared by consecutive segments
+ * @param average Averaging mode
+ * @param sampleRate Sample rate
+ * @param threads Number of threads, 0 for one per core
+ *
+ * @return Two-sided power spectral density, one value per FFT bin
+ */
+std::vector<double> calcWelchPSD
+(
+    const std::vector<complex_t>& sig,
+    const std::vector<double>& window,
+    const size_t overlap,
+    const WelchAverage average = WELCH_MEAN,
+    const double sampleRate = 1.0,
+    const size_t threads = 0
+);
+
+#endif
@@ -0,0 +1,60 @@
+#include "window.h"
+#include "libdsp.h"
+
+std::vector<double> makeWindow
+(
+    const WindowType type,
+    const size_t N,
+    const bool periodic
+)
+{
+    std::vector<double> w(N, 1.0);
+    if(N < 2 || type == WINDOW_RECTANGULAR)
+    {
+        return w;
+    }
+
+    const double L = periodic ? (double)N : (double)(N - 1);
+    for(size_t i = 0; i < N; i++)
+    {
+        double x = 2.0 * M_PI * (double)i / L;
+        switch(type)
+        {
+            case WINDOW_HANN:
+                w[i] = 0.5 - 0.5 * std::cos(x);
+                break;
+            case WINDOW_HAMMING:
+                w[i] = 0.54 - 0.46 * std::cos(x);
+                break;
+            case WINDOW_BLACKMAN:
+                w[i] = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+                break;
+            default:
+                break;
+        }
+    }
+    return w;
+}
+
+std::vector<double> designLowpass
+(
+    const size_t numTaps,
+    const double cutoff,
+    const WindowType type
+)
+{
+    std::vector<double> h = makeWindow(type, numTaps, false);
+    const double mid = 0.5 * (double)(numTaps - 1);
+    double sum = 0.0;
+    for(size_t i = 0; i < numTaps; i++)
+    {
+        double t = (double)i - mid;
+        h[i] *= t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        sum += h[i];
+    }
+    for(size_t i = 0; i < numTaps && sum != 0.0; i++)
+    {
+        h[i] /= sum;
+    }
+    return h;
+}
@@ -0,0 +1,57 @@
+/*************  ✨ Window Functions 🌟  *************/
+/**
+ * \file window.h
+ * \brief Tapering windows for spectral estimation and filter design
+ */
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * \brief Supported window shapes
+ */
+enum WindowType
+{
+    WINDOW_RECTANGULAR,
+    WINDOW_HANN,
+    WINDOW_HAMMING,
+    WINDOW_BLACKMAN
+};
+
+/**
+ * \brief Build a window
+ * 
+ * @param type Window shape
+ * @param N Window length
+ * @param periodic True for the periodic form used in spectral analysis (period N),
+ *                 false for the symmetric form used in filter design (period N - 1)
+ * 
+ * @return The N window coefficients
+ */
+std::vector<double> makeWindow
+(
+    const WindowType type,
+    const size_t N,
+    const bool periodic = true
+);
+
+/**
+ * \brief Design a windowed-sinc low-pass FIR filter
+ * 
+ * @param numTaps Number of taps
+ * @param cutoff Cutoff frequency as a fraction of the sample rate, in (0, 0.5)
+ * @param type Window applied to the ideal impulse response
+ * 
+ * @return The filter taps, normalized to unity gain at 0 Hz
+ */
+std::vector<double> designLowpass
+(
+    const size_t numTaps,
+    const double cutoff,
+    const WindowType type = WINDOW_HAMMING
+);
+
+#endif